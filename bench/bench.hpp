@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+namespace navp::bench {
+
+// keep the optimizer from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& val) {
+  asm volatile("" : : "r,m"(val) : "memory");
+}
+
+// wall time of one call to f, in seconds
+template <typename F>
+double time_s(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  std::forward<F>(f)();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// best of `reps` runs, to filter out scheduling noise
+template <typename F>
+double best_of(int reps, F&& f) {
+  double best = time_s(f);
+  for (int i = 1; i < reps; ++i) {
+    double t = time_s(f);
+    best = t < best ? t : best;
+  }
+  return best;
+}
+
+inline void report(const char* name, double ops, double seconds) {
+  std::printf("%-40s %12.2f ns/op %14.0f ops/s\n", name, seconds * 1e9 / ops, ops / seconds);
+}
+
+}  // namespace navp::bench
@@ -0,0 +1,78 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_boxed.hpp"
+
+namespace bench = navp::bench;
+using navp::Option;
+
+// a 1.5 KiB record of a sparse data model, most rows do not have one
+struct Record {
+  std::uint64_t id;
+  std::array<char, 1528> payload;
+};
+
+template <typename Repr>
+static void run(const char* name, double none_ratio) {
+  constexpr std::size_t rows = 20000, probes = 1 << 20;
+  std::mt19937 rng(11);
+  std::bernoulli_distribution absent(none_ratio);
+  char label[64];
+
+  std::vector<Option<Record, Repr>> table(rows);
+  std::size_t somes = 0;
+  std::snprintf(label, sizeof label, "%.0f%% None, %s, fill", none_ratio * 100, name);
+  bench::report(label, rows, bench::time_s([&] {
+                  for (std::size_t i = 0; i < rows; ++i) {
+                    if (!absent(rng)) {
+                      table[i].insert(Record{i, {}});
+                      ++somes;
+                    }
+                  }
+                }));
+
+  // the table itself, plus the pool blocks of the boxed payloads
+  std::size_t bytes = rows * sizeof(Option<Record, Repr>);
+  if constexpr (std::is_same_v<Repr, navp::Boxed>) {
+    bytes += somes * navp::details::box_pool<sizeof(Record), alignof(Record)>::block_size;
+  }
+  std::printf("%-40s %12.2f MiB\n", "  footprint", bytes / 1048576.0);
+
+  std::snprintf(label, sizeof label, "%.0f%% None, %s, scan", none_ratio * 100, name);
+  bench::report(label, rows, bench::best_of(5, [&] {
+                  std::uint64_t sum = 0;
+                  for (const auto& row : table) {
+                    sum += row.map_or([](const Record& r) { return r.id; }, std::uint64_t{0});
+                  }
+                  bench::do_not_optimize(sum);
+                }));
+
+  std::vector<std::uint32_t> indices(probes);
+  for (auto& i : indices) {
+    i = static_cast<std::uint32_t>(rng() % rows);
+  }
+  std::snprintf(label, sizeof label, "%.0f%% None, %s, random", none_ratio * 100, name);
+  bench::report(label, probes, bench::best_of(5, [&] {
+                  std::uint64_t sum = 0;
+                  for (auto i : indices) {
+                    const auto& row = table[i];
+                    sum += row.is_some() ? row.unwrap().id : 0;
+                  }
+                  bench::do_not_optimize(sum);
+                }));
+}
+
+int main() {
+  std::printf("sizeof Option<Record>: %zu, Option<Record, Boxed>: %zu\n", sizeof(Option<Record>),
+              sizeof(Option<Record, navp::Boxed>));
+  for (double ratio : {0.0, 0.5, 0.9, 0.95, 0.99}) {
+    run<navp::Tagged>("inline", ratio);
+    run<navp::Boxed>("boxed", ratio);
+  }
+}
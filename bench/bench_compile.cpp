@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// compile-time benchmark: generates a unit instantiating Option over N distinct payload types across the api,
+// then times the compiler on it against the same unit with N = 0, so template cost regressions show up
+// usage: bench_compile [N...]
+// the compiler is $CXX (default c++) with $CXXFLAGS, add -DNAVP_OPTION_CPPTRACE (and its include path) to measure with cpptrace
+
+namespace fs = std::filesystem;
+
+// the bench targets are given the project directory, a direct build falls back to this file's location
+#ifndef NAVP_PROJECT_DIR
+#define NAVP_PROJECT_DIR ""
+#endif
+
+static fs::path project_dir() {
+  fs::path dir = NAVP_PROJECT_DIR;
+  return dir.empty() ? fs::absolute(fs::path(__FILE__)).parent_path().parent_path() : dir;
+}
+
+static void generate(const fs::path& file, int n) {
+  std::ofstream out(file);
+  out << "#include \"option.hpp\"\n";
+  for (int i = 0; i < n; ++i) {
+    out << "namespace t" << i << " {\n"
+        << "struct P { int v; bool operator==(const P&) const = default; };\n"
+        << "struct Q { long v; Q(P p) : v(p.v) {} };\n"
+        << "int use(int x) {\n"
+        << "  navp::Option<P> a(P{x});\n"
+        << "  navp::Option<P> b = navp::None;\n"
+        << "  navp::Option<P, navp::Tagged> c = a;\n"
+        << "  navp::Option<Q> d = c;\n"
+        << "  navp::Option<Q> e(std::in_place, P{x});\n"
+        << "  navp::Option<navp::Option<P>> f(std::in_place, a);\n"
+        << "  b = a;\n"
+        << "  b.replace(P{x + 1});\n"
+        << "  int sum = a.unwrap().v + b.unwrap_or(P{0}).v + (a == c) + d.is_some() + e.is_none() + f.is_some();\n"
+        << "  sum += a.is_some_and([](const P& p) { return p.v > 0; });\n"
+        << "  return sum + static_cast<int>(d.unwrap_or(Q(P{0})).v);\n"
+        << "}\n"
+        << "}  // namespace t" << i << "\n";
+  }
+}
+
+// seconds the compiler spends on the unit, parsing and instantiating only
+static double compile(const fs::path& file) {
+  const char* cxx = std::getenv("CXX");
+  const char* flags = std::getenv("CXXFLAGS");
+  auto root = project_dir();
+  std::string command = std::string(cxx != nullptr ? cxx : "c++") + " -std=c++23 -fsyntax-only " +
+                        (flags != nullptr ? flags : "") + " -I\"" + root.string() + "\" \"" + file.string() + "\"";
+  auto start = std::chrono::steady_clock::now();
+  if (std::system(command.c_str()) != 0) {
+    std::fprintf(stderr, "compile failed: %s\n", command.c_str());
+    std::exit(1);
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// best of three, the first run also warms the file cache
+static double best_compile(const fs::path& file) {
+  double best = compile(file);
+  for (int i = 1; i < 3; ++i) {
+    double t = compile(file);
+    best = t < best ? t : best;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  auto file = fs::temp_directory_path() / "navp_bench_compile.cpp";
+  generate(file, 0);
+  double base = best_compile(file);
+  std::printf("%-28s %8.3f s\n", "include only", base);
+  for (int i = 1; i < argc || i == 1; ++i) {
+    int n = i < argc ? std::atoi(argv[i]) : 500;
+    generate(file, n);
+    double t = best_compile(file);
+    std::printf("%6d payload types %13.3f s %10.1f us/type\n", n, t, (t - base) * 1e6 / n);
+    std::fflush(stdout);
+  }
+  fs::remove(file);
+}
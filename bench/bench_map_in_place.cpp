@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+
+namespace bench = navp::bench;
+using navp::None;
+using navp::Option;
+
+// a normalization chain over names read from a file: trim, lower case, spaces to underscores
+// every step keeps the type, so the payload's buffer can serve the whole chain
+
+static std::string_view trimmed(std::string_view s) {
+  auto first = s.find_first_not_of(' ');
+  if (first == std::string_view::npos) {
+    return s.substr(s.size());
+  }
+  return s.substr(first, s.find_last_not_of(' ') - first + 1);
+}
+
+static char lower(char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+static char underscore(char c) { return c == ' ' ? '_' : c; }
+
+int main() {
+  constexpr std::size_t count = 1 << 16;
+  std::mt19937 rng(3);
+  std::vector<Option<std::string>> input(count);
+  for (auto& o : input) {
+    // one in eight missing, the rest well past the small string buffer
+    if (rng() % 8 != 0) {
+      std::string s(2 + rng() % 4, ' ');
+      for (int w = 0; w < 6; ++w) {
+        s += "Word";
+        s += static_cast<char>('A' + rng() % 26);
+        s += ' ';
+      }
+      o = std::move(s);
+    }
+  }
+
+  auto measure = [&](const char* how, auto&& chain) {
+    bench::report(how, count, bench::best_of(5, [&] {
+                    auto work = input;
+                    std::size_t sum = 0;
+                    for (auto& o : work) {
+                      sum += chain(o).map_or([](const std::string& s) { return s.size(); }, 0);
+                    }
+                    bench::do_not_optimize(sum);
+                  }));
+  };
+
+  measure("copy only", [](Option<std::string>& o) -> Option<std::string>& { return o; });
+
+  // each step reads the previous string and builds the next one
+  measure("map, f(const std::string&)", [](Option<std::string>& o) {
+    return o.map([](const std::string& s) { return std::string(trimmed(s)); })
+        .map([](const std::string& s) {
+          std::string out(s.size(), '\0');
+          std::transform(s.begin(), s.end(), out.begin(), lower);
+          return out;
+        })
+        .map([](const std::string& s) {
+          std::string out(s.size(), '\0');
+          std::transform(s.begin(), s.end(), out.begin(), underscore);
+          return out;
+        });
+  });
+
+  // through an rvalue the payload moves into f and back out, one buffer for the chain
+  measure("std::move(o).map, f(std::string)", [](Option<std::string>& o) {
+    return std::move(o)
+        .map([](std::string s) {
+          auto t = trimmed(s);
+          s.erase(static_cast<std::size_t>(t.data() - s.data()) + t.size());
+          s.erase(0, static_cast<std::size_t>(t.data() - s.data()));
+          return s;
+        })
+        .map([](std::string s) {
+          std::transform(s.begin(), s.end(), s.begin(), lower);
+          return s;
+        })
+        .map([](std::string s) {
+          std::transform(s.begin(), s.end(), s.begin(), underscore);
+          return s;
+        });
+  });
+
+  // the payload is edited where it is, nothing moves
+  measure("map_in_place", [](Option<std::string>& o) -> Option<std::string>& {
+    return o
+        .map_in_place([](std::string& s) {
+          auto t = trimmed(s);
+          s.erase(static_cast<std::size_t>(t.data() - s.data()) + t.size());
+          s.erase(0, static_cast<std::size_t>(t.data() - s.data()));
+        })
+        .map_in_place([](std::string& s) { std::transform(s.begin(), s.end(), s.begin(), lower); })
+        .map_in_place([](std::string& s) { std::transform(s.begin(), s.end(), s.begin(), underscore); });
+  });
+}
@@ -0,0 +1,56 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "mpmc_queue.hpp"
+
+using navp::MpmcQueue;
+namespace bench = navp::bench;
+
+// every producer pushes `per_producer` items, consumers pop until all of them are drained
+static void run(int producers, int consumers, long per_producer) {
+  MpmcQueue<long> queue(1024);
+  const long total = producers * per_producer;
+  double seconds = bench::best_of(3, [&] {
+    std::atomic<long> popped{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&] {
+        while (!go.load(std::memory_order_acquire)) navp::details::cpu_relax();
+        for (long i = 0; i < per_producer; ++i) {
+          while (!queue.try_push(i)) std::this_thread::yield();
+        }
+      });
+    }
+    for (int c = 0; c < consumers; ++c) {
+      threads.emplace_back([&] {
+        while (!go.load(std::memory_order_acquire)) navp::details::cpu_relax();
+        long sum = 0;
+        while (popped.load(std::memory_order_relaxed) < total) {
+          if (auto o = queue.try_pop()) {
+            sum += o.unwrap_unchecked();
+            popped.fetch_add(1, std::memory_order_relaxed);
+          } else {
+            std::this_thread::yield();
+          }
+        }
+        bench::do_not_optimize(sum);
+      });
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+  });
+  char name[64];
+  std::snprintf(name, sizeof name, "mpmc_queue %dP%dC", producers, consumers);
+  bench::report(name, double(total), seconds);
+}
+
+int main() {
+  constexpr long items = 1 << 20;
+  run(1, 1, items);
+  run(4, 4, items / 4);
+  run(16, 16, items / 16);
+}
@@ -0,0 +1,35 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+
+using navp::NanBoxed;
+using navp::None;
+using navp::Option;
+namespace bench = navp::bench;
+
+// sum of the Some values of a column, one None in eight
+template <typename O>
+static void scan(const char* name, std::size_t rows) {
+  std::vector<O> column(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    if (i % 8 != 0) column[i] = O(double(i));
+  }
+  double seconds = bench::best_of(5, [&] {
+    double sum = 0;
+    for (const auto& o : column) {
+      sum += o.is_some() ? o.unwrap_unchecked() : 0.0;
+    }
+    bench::do_not_optimize(sum);
+  });
+  double bytes = double(rows * sizeof(O));
+  std::printf("%-28s %2zu B/row %8.2f ns/row %8.2f GB/s\n", name, sizeof(O), seconds * 1e9 / double(rows),
+              bytes / seconds / 1e9);
+}
+
+int main() {
+  constexpr std::size_t rows = 1 << 24;  // 128 MiB of doubles, well past the caches
+  scan<Option<double>>("Option<double>", rows);
+  scan<Option<double, NanBoxed>>("Option<double, NanBoxed>", rows);
+}
@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+
+using navp::None;
+using navp::Option;
+using navp::Tagged;
+namespace bench = navp::bench;
+
+// fill a vector by push_back, so growth moves every element a few times, then sum the Some payloads
+template <typename O, typename Make, typename Read>
+static void run(const char* name, std::size_t rows, Make make, Read read) {
+  std::vector<O> column;
+  double fill = bench::best_of(3, [&] {
+    std::vector<O> fresh;
+    for (std::size_t i = 0; i < rows; ++i) {
+      i % 8 == 0 ? fresh.push_back(O(None)) : fresh.push_back(O(make(i)));
+    }
+    column = std::move(fresh);
+  });
+  double scan = bench::best_of(5, [&] {
+    std::size_t sum = 0;
+    for (const auto& o : column) {
+      sum += o.is_some() ? read(o.unwrap()) : 0;
+    }
+    bench::do_not_optimize(sum);
+  });
+  std::printf("%-36s %2zu B/row  fill %6.2f ns/row  scan %6.2f ns/row\n", name, sizeof(O),
+              fill * 1e9 / double(rows), scan * 1e9 / double(rows));
+}
+
+int main() {
+  constexpr std::size_t rows = 1 << 22;
+  std::vector<int> targets(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    targets[i] = int(i);
+  }
+
+  auto raw = [&](std::size_t i) { return &targets[i]; };
+  auto deref = [](const int* p) { return std::size_t(*p); };
+  run<Option<int*>>("Option<int*>", rows, raw, deref);
+  run<Option<int*, Tagged>>("Option<int*, Tagged>", rows, raw, deref);
+
+  auto owned = [](std::size_t i) { return std::make_unique<int>(int(i)); };
+  auto deref_owned = [](const std::unique_ptr<int>& p) { return std::size_t(*p); };
+  run<Option<std::unique_ptr<int>>>("Option<unique_ptr<int>>", rows, owned, deref_owned);
+  run<Option<std::unique_ptr<int>, Tagged>>("Option<unique_ptr<int>, Tagged>", rows, owned, deref_owned);
+
+  auto shared = [](std::size_t i) { return std::make_shared<int>(int(i)); };
+  auto deref_shared = [](const std::shared_ptr<int>& p) { return std::size_t(*p); };
+  run<Option<std::shared_ptr<int>>>("Option<shared_ptr<int>>", rows, shared, deref_shared);
+  run<Option<std::shared_ptr<int>, Tagged>>("Option<shared_ptr<int>, Tagged>", rows, shared, deref_shared);
+}
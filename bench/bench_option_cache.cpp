@@ -0,0 +1,63 @@
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "option_cache.hpp"
+
+using navp::None;
+using navp::Option;
+using navp::OptionCache;
+namespace bench = navp::bench;
+
+// stands in for an upstream lookup, half of the keys are absent
+static Option<long> backend(const long& key) {
+  long acc = key;
+  for (int i = 0; i < 200; ++i) {
+    acc = acc * 6364136223846793005l + 1442695040888963407l;
+  }
+  bench::do_not_optimize(acc);
+  return key % 2 == 0 ? Option<long>(key) : None;
+}
+
+// every thread does `ops` get_or_compute calls on keys drawn uniformly from [0, keys)
+static void run(const char* label, int threads, long keys, std::size_t capacity, long ops) {
+  OptionCache<long, long> cache(capacity);
+  std::atomic<long> computed{0};
+  auto compute = [&](const long& key) {
+    computed.fetch_add(1, std::memory_order_relaxed);
+    return backend(key);
+  };
+  // warm up so the hit case measures hits
+  for (long k = 0; k < keys && k < long(capacity); ++k) cache.get_or_compute(k, compute);
+  computed = 0;
+  double seconds = bench::time_s([&] {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+      pool.emplace_back([&, t] {
+        std::mt19937_64 rng(t);
+        long some = 0;
+        for (long i = 0; i < ops; ++i) {
+          some += cache.get_or_compute(long(rng() % keys), compute).is_some();
+        }
+        bench::do_not_optimize(some);
+      });
+    }
+    for (auto& th : pool) th.join();
+  });
+  char name[80];
+  std::snprintf(name, sizeof name, "%s %dt (computed %ld)", label, threads, computed.load());
+  bench::report(name, double(ops) * threads, seconds);
+}
+
+int main() {
+  constexpr long ops = 200000;
+  for (int threads : {1, 2, 4, 8}) {
+    run("option_cache hits", threads, 4096, 8192, ops);
+  }
+  for (int threads : {1, 2, 4, 8}) {
+    run("option_cache half-miss", threads, 16384, 8192, ops);
+  }
+}
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_coroutine.hpp"
+
+using navp::None;
+using navp::Option;
+namespace bench = navp::bench;
+
+// four dependent lookups, each one can miss
+static std::vector<std::uint32_t> table;
+
+[[gnu::noinline]] static Option<std::uint32_t> lookup(std::uint32_t key) {
+  auto val = table[key & (table.size() - 1)];
+  return val == 0 ? Option<std::uint32_t>(None) : Option<std::uint32_t>(val);
+}
+
+static Option<std::uint32_t> ladder(std::uint32_t key) {
+  auto a = lookup(key);
+  if (a.is_none()) {
+    return None;
+  }
+  auto b = lookup(a.unwrap());
+  if (b.is_none()) {
+    return None;
+  }
+  auto c = lookup(b.unwrap());
+  if (c.is_none()) {
+    return None;
+  }
+  auto d = lookup(c.unwrap());
+  if (d.is_none()) {
+    return None;
+  }
+  return d.unwrap() + 1;
+}
+
+static Option<std::uint32_t> coroutine(std::uint32_t key) {
+  auto a = co_await lookup(key);
+  auto b = co_await lookup(a);
+  auto c = co_await lookup(b);
+  co_return co_await lookup(c) + 1;
+}
+
+// lifo bump arena, a frame freed before the next call is allocated is reused right away
+struct Arena {
+  alignas(std::max_align_t) unsigned char buffer[4096];
+  std::size_t top = 0;
+};
+
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) noexcept : arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+  T* allocate(std::size_t n) {
+    auto* p = arena->buffer + arena->top;
+    arena->top += n * sizeof(T);
+    return reinterpret_cast<T*>(p);
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (reinterpret_cast<unsigned char*>(p) + n * sizeof(T) == arena->buffer + arena->top) {
+      arena->top -= n * sizeof(T);
+    }
+  }
+
+  Arena* arena;
+};
+
+static Option<std::uint32_t> arena_coroutine(std::allocator_arg_t, ArenaAllocator<std::byte>, std::uint32_t key) {
+  auto a = co_await lookup(key);
+  auto b = co_await lookup(a);
+  auto c = co_await lookup(b);
+  co_return co_await lookup(c) + 1;
+}
+
+// miss_every: one slot in miss_every is empty, so the chain short-circuits at some depth
+static void run(std::uint32_t miss_every) {
+  constexpr std::size_t keys = 1 << 12;
+  table.assign(keys, 0);
+  for (std::size_t i = 0; i < keys; ++i) {
+    table[i] = miss_every != 0 && i % miss_every == 0 ? 0 : std::uint32_t(i * 2654435761u) | 1u;
+  }
+  constexpr std::size_t calls = 1 << 22;
+  Arena arena;
+  auto measure = [&](const char* name, auto&& f) {
+    char label[64];
+    std::snprintf(label, sizeof label, "%s, miss 1/%u", name, miss_every);
+    bench::report(label, calls, bench::best_of(5, [&] {
+                    std::uint64_t sum = 0;
+                    for (std::uint32_t k = 0; k < calls; ++k) {
+                      sum += f(k).unwrap_or(0);
+                    }
+                    bench::do_not_optimize(sum);
+                  }));
+  };
+  measure("if ladder", [](std::uint32_t k) { return ladder(k); });
+  measure("co_await, heap frame", [](std::uint32_t k) { return coroutine(k); });
+  measure("co_await, arena frame", [&](std::uint32_t k) {
+    return arena_coroutine(std::allocator_arg, ArenaAllocator<std::byte>(arena), k);
+  });
+}
+
+int main() {
+  run(0);
+  run(64);
+  run(4);
+}
@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_lookup.hpp"
+
+namespace bench = navp::bench;
+
+struct string_hash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+// the three ways of reading a key that may be missing, over the same probes, half of which miss
+template <typename M>
+static void run(const char* name, M& m, const std::vector<std::string>& probes) {
+  auto measure = [&](const char* how, auto&& lookup) {
+    char label[64];
+    std::snprintf(label, sizeof label, "%s, %s", name, how);
+    bench::report(label, probes.size(), bench::best_of(5, [&] {
+                    long sum = 0;
+                    for (const auto& key : probes) {
+                      sum += lookup(std::string_view(key));
+                    }
+                    bench::do_not_optimize(sum);
+                  }));
+  };
+  measure("contains + at", [&](std::string_view k) { return m.contains(k) ? m.find(k)->second : 0; });
+  measure("find != end", [&](std::string_view k) {
+    auto it = m.find(k);
+    return it == m.end() ? 0 : it->second;
+  });
+  measure("navp::get", [&](std::string_view k) {
+    auto v = navp::get(m, k);
+    return v ? v.unwrap() : 0;
+  });
+}
+
+int main() {
+  constexpr std::size_t keys = 1 << 14, lookups = 1 << 20;
+  std::unordered_map<std::string, int, string_hash, std::equal_to<>> hashed;
+  std::map<std::string, int, std::less<>> sorted;
+  for (std::size_t i = 0; i < keys; ++i) {
+    auto key = "key." + std::to_string(i * 2);
+    hashed.emplace(key, static_cast<int>(i));
+    sorted.emplace(key, static_cast<int>(i));
+  }
+  std::mt19937 rng(7);
+  std::vector<std::string> probes(lookups);
+  for (auto& p : probes) {
+    p = "key." + std::to_string(rng() % (keys * 2));
+  }
+  run("unordered_map", hashed, probes);
+  run("map", sorted, probes);
+
+  std::vector<int> column(keys);
+  for (std::size_t i = 0; i < keys; ++i) {
+    column[i] = static_cast<int>(i);
+  }
+  std::vector<std::size_t> indices(lookups);
+  for (auto& i : indices) {
+    i = rng() % (keys * 2);
+  }
+  auto measure = [&](const char* how, auto&& lookup) {
+    bench::report(how, lookups, bench::best_of(5, [&] {
+                    long sum = 0;
+                    for (auto i : indices) {
+                      sum += lookup(i);
+                    }
+                    bench::do_not_optimize(sum);
+                  }));
+  };
+  measure("vector, i < size ? v[i]", [&](std::size_t i) { return i < column.size() ? column[i] : 0; });
+  measure("vector, navp::get", [&](std::size_t i) {
+    auto v = navp::get(column, i);
+    return v ? v.unwrap() : 0;
+  });
+}
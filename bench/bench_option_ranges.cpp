@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <cstdio>
+#include <ranges>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_ranges.hpp"
+
+using navp::None;
+using navp::Option;
+namespace bench = navp::bench;
+namespace views = navp::views;
+
+// a computation that can miss, one call in miss_every returns None
+static std::uint32_t miss_every;
+
+static Option<std::uint32_t> compute(std::uint32_t i) {
+  auto val = i * 2654435761u;
+  return i % miss_every == miss_every - 1 ? Option<std::uint32_t>(None) : Option<std::uint32_t>(val >> 8);
+}
+
+// the same work done by a hand-written loop and by the adaptor, over a stored column and over a lazy stream
+static void run(std::uint32_t every) {
+  miss_every = every;
+  constexpr std::size_t rows = 1 << 22;
+  std::vector<Option<std::uint32_t>> column;
+  column.reserve(rows);
+  for (std::uint32_t i = 0; i < rows; ++i) {
+    column.push_back(compute(i));
+  }
+  auto stream = std::views::iota(std::uint32_t{0}, std::uint32_t{rows}) |
+                std::views::transform([](std::uint32_t i) { return compute(i); });
+
+  auto measure = [&](const char* name, auto&& f) {
+    char label[64];
+    std::snprintf(label, sizeof label, "%s, miss 1/%u", name, every);
+    bench::report(label, rows, bench::best_of(5, [&] { bench::do_not_optimize(f()); }));
+  };
+
+  measure("sum somes, column loop", [&] {
+    std::uint64_t sum = 0;
+    for (const auto& o : column) {
+      if (o.is_some()) {
+        sum += o.unwrap();
+      }
+    }
+    return sum;
+  });
+  measure("sum somes, column views::somes", [&] {
+    std::uint64_t sum = 0;
+    for (auto v : column | views::somes) {
+      sum += v;
+    }
+    return sum;
+  });
+  measure("sum somes, stream loop", [&] {
+    std::uint64_t sum = 0;
+    for (std::uint32_t i = 0; i < rows; ++i) {
+      auto o = compute(i);
+      if (o.is_some()) {
+        sum += o.unwrap();
+      }
+    }
+    return sum;
+  });
+  measure("sum somes, stream views::somes", [&] {
+    std::uint64_t sum = 0;
+    for (auto v : stream | views::somes) {
+      sum += v;
+    }
+    return sum;
+  });
+  measure("sum somes, stream copy then filter", [&] {
+    std::vector<Option<std::uint32_t>> copy(stream.begin(), stream.end());
+    std::uint64_t sum = 0;
+    for (const auto& o : copy) {
+      if (o.is_some()) {
+        sum += o.unwrap();
+      }
+    }
+    return sum;
+  });
+
+  measure("prefix, column loop", [&] {
+    std::uint64_t sum = 0;
+    for (const auto& o : column) {
+      if (o.is_none()) {
+        break;
+      }
+      sum += o.unwrap();
+    }
+    return sum;
+  });
+  measure("prefix, column views::take_while_some", [&] {
+    std::uint64_t sum = 0;
+    for (auto v : column | views::take_while_some) {
+      sum += v;
+    }
+    return sum;
+  });
+
+  measure("collect, stream loop", [&] {
+    std::vector<std::uint32_t> values;
+    values.reserve(rows);
+    for (std::uint32_t i = 0; i < rows; ++i) {
+      auto o = compute(i);
+      if (o.is_none()) {
+        break;
+      }
+      values.push_back(o.unwrap());
+    }
+    return values.size();
+  });
+  measure("collect, stream collect_option", [&] { return navp::collect_option(stream).is_some(); });
+}
+
+// with misses the prefix and the collect stop at the first None, which is the early exit being measured
+int main() {
+  // no miss at all, so the prefix and the collect walk every row
+  run(0xffffffffu);
+  run(64);
+  run(4);
+}
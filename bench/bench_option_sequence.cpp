@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_parallel.hpp"
+#include "thread_pool.hpp"
+
+using navp::None;
+using navp::Option;
+using navp::Sentinel;
+namespace bench = navp::bench;
+
+// the loop sequence replaces, one branch and one push_back per element
+template <typename O>
+static Option<std::vector<typename O::value_type>> naive_sequence(const std::vector<O>& column) {
+  std::vector<typename O::value_type> values;
+  for (const auto& o : column) {
+    if (o.is_none()) {
+      return None;
+    }
+    values.push_back(o.unwrap());
+  }
+  return values;
+}
+
+// none_at: where the single None sits as a fraction of the column, 1 for a column without None
+template <typename O>
+static void run(const char* name, double none_at, const std::vector<std::size_t>& thread_counts) {
+  constexpr std::size_t rows = 1 << 24;
+  std::vector<O> column(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    column[i] = static_cast<std::uint32_t>(i);
+  }
+  if (none_at < 1) {
+    column[static_cast<std::size_t>(none_at * rows)] = None;
+  }
+  auto measure = [&](const char* how, auto&& f) {
+    char label[96];
+    std::snprintf(label, sizeof label, "%s, None at %.2f, %s", name, none_at, how);
+    bench::report(label, rows, bench::best_of(5, [&] { bench::do_not_optimize(f().is_some()); }));
+  };
+  measure("naive loop", [&] { return naive_sequence(column); });
+  measure("sequence", [&] { return navp::sequence(column); });
+  for (auto threads : thread_counts) {
+    navp::ThreadPool pool(threads);
+    char how[32];
+    std::snprintf(how, sizeof how, "sequence on %zu threads", threads);
+    measure(how, [&] { return navp::sequence(pool, column); });
+  }
+}
+
+// traverse over a parse that costs a few hundred cycles, so the pool has real work to split
+static Option<std::uint32_t> parse(std::uint32_t x) {
+  for (int i = 0; i < 64; ++i) {
+    x = x * 2654435761u + 1;
+  }
+  return x == 0 ? Option<std::uint32_t>(None) : Option<std::uint32_t>(x);
+}
+
+static void run_traverse(const std::vector<std::size_t>& thread_counts) {
+  constexpr std::size_t rows = 1 << 20;
+  std::vector<std::uint32_t> inputs(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    inputs[i] = static_cast<std::uint32_t>(i);
+  }
+  bench::report("traverse, serial", rows, bench::best_of(5, [&] {
+                  bench::do_not_optimize(navp::traverse(inputs, parse).is_some());
+                }));
+  for (auto threads : thread_counts) {
+    navp::ThreadPool pool(threads);
+    char label[64];
+    std::snprintf(label, sizeof label, "traverse on %zu threads", threads);
+    bench::report(label, rows, bench::best_of(5, [&] {
+                    bench::do_not_optimize(navp::traverse(pool, inputs, parse).is_some());
+                  }));
+  }
+}
+
+int main() {
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t t = 1; t <= std::thread::hardware_concurrency(); t *= 2) {
+    thread_counts.push_back(t);
+  }
+  for (double none_at : {1.0, 0.5, 0.01}) {
+    run<Option<std::uint32_t>>("Option<u32>", none_at, thread_counts);
+    run<Option<std::uint32_t, Sentinel<~0u>>>("Option<u32, Sentinel>", none_at, thread_counts);
+  }
+  run_traverse(thread_counts);
+}
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "option_parallel.hpp"
+#include "thread_pool.hpp"
+
+using navp::None;
+using navp::Option;
+namespace bench = navp::bench;
+
+// a validation costing a few microseconds, the one at `failing` returns None
+static Option<std::uint32_t> validate(std::size_t i, std::size_t failing, std::stop_token stop = {}) {
+  std::uint32_t x = static_cast<std::uint32_t>(i) | 1u;
+  for (int round = 0; round < 64; ++round) {
+    if (stop.stop_requested()) {
+      return None;
+    }
+    for (int j = 0; j < 256; ++j) {
+      x = x * 2654435761u + 1;
+    }
+  }
+  bench::do_not_optimize(x);
+  return i == failing ? Option<std::uint32_t>(None) : Option<std::uint32_t>(x);
+}
+
+constexpr std::size_t tasks = 32;
+
+static bool sequential(std::size_t failing) {
+  for (std::size_t i = 0; i < tasks; ++i) {
+    if (validate(i, failing).is_none()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// std::async runs every task to the end, it has no way to call off the others
+static bool async_all(std::size_t failing) {
+  std::vector<std::future<Option<std::uint32_t>>> futures;
+  for (std::size_t i = 0; i < tasks; ++i) {
+    futures.push_back(std::async(std::launch::async, [=] { return validate(i, failing); }));
+  }
+  bool all = true;
+  for (auto& f : futures) {
+    all &= f.get().is_some();
+  }
+  return all;
+}
+
+static bool parallel(navp::ThreadPool& pool, std::size_t failing) {
+  return [&]<std::size_t... I>(std::index_sequence<I...>) {
+    return navp::all_some_parallel(pool, [=](std::stop_token stop) { return validate(I, failing, stop); }...).is_some();
+  }(std::make_index_sequence<tasks>{});
+}
+
+int main() {
+  navp::ThreadPool pool(std::thread::hardware_concurrency());
+  // failing == tasks means every validation passes
+  for (std::size_t failing : {std::size_t{0}, tasks / 4, tasks / 2, tasks - 1, tasks}) {
+    auto measure = [&](const char* how, auto&& f) {
+      char label[64];
+      std::snprintf(label, sizeof label, "all some, None at %zu/%zu, %s", failing, tasks, how);
+      bench::report(label, 1, bench::best_of(9, [&] { bench::do_not_optimize(f()); }));
+    };
+    measure("sequential", [&] { return sequential(failing); });
+    measure("std::async", [&] { return async_all(failing); });
+    measure("all_some_parallel", [&] { return parallel(pool, failing); });
+  }
+
+  constexpr std::size_t candidates = 1024;
+  std::vector<std::size_t> ids(candidates);
+  for (std::size_t i = 0; i < candidates; ++i) {
+    ids[i] = i;
+  }
+  for (std::size_t hit : {std::size_t{0}, candidates / 8, candidates / 2, candidates}) {
+    // every candidate costs one validation, the one at `hit` is accepted
+    auto accept = [hit](std::size_t i) {
+      return validate(i, candidates).is_some() && i == hit ? Option<std::size_t>(i) : Option<std::size_t>(None);
+    };
+    auto measure = [&](const char* how, auto&& f) {
+      char label[64];
+      std::snprintf(label, sizeof label, "first some, Some at %zu/%zu, %s", hit, candidates, how);
+      bench::report(label, 1, bench::best_of(5, [&] { bench::do_not_optimize(f().is_some()); }));
+    };
+    measure("sequential", [&] {
+      for (auto i : ids) {
+        if (auto o = accept(i); o.is_some()) {
+          return o;
+        }
+      }
+      return Option<std::size_t>(None);
+    });
+    measure("first_some_parallel", [&] { return navp::first_some_parallel(pool, ids, accept); });
+  }
+}
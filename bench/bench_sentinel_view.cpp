@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "option.hpp"
+#include "sentinel_view.hpp"
+
+using navp::Option;
+using navp::SentinelView;
+namespace bench = navp::bench;
+
+int main() {
+  constexpr std::size_t rows = 1 << 24;
+  std::vector<std::int32_t> raw(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    raw[i] = i % 8 == 0 ? -1 : std::int32_t(i);
+  }
+  std::vector<std::int32_t> dense(rows, 1);
+  dense[rows - 1] = -1;  // find_first_none has to scan everything
+  SentinelView<std::int32_t> view(raw);
+  SentinelView<std::int32_t> dense_view(dense);
+
+  bench::report("count_some, scalar loop", rows, bench::best_of(5, [&] {
+                  std::size_t count = 0;
+                  for (std::size_t i = 0; i < rows; ++i) {
+                    if (raw[i] != -1) {
+                      ++count;
+                    }
+                    asm volatile("" : "+r"(count));  // keep this one scalar
+                  }
+                  bench::do_not_optimize(count);
+                }));
+  bench::report("count_some, SentinelView", rows,
+                bench::best_of(5, [&] { bench::do_not_optimize(view.count_some()); }));
+  bench::report("count_some, vector<Option> copy", rows, bench::best_of(5, [&] {
+                  std::vector<Option<std::int32_t>> opts;
+                  opts.reserve(rows);
+                  for (auto v : raw) {
+                    opts.push_back(v == -1 ? Option<std::int32_t>() : Option<std::int32_t>(v));
+                  }
+                  std::size_t count = 0;
+                  for (const auto& o : opts) {
+                    count += o.is_some();
+                  }
+                  bench::do_not_optimize(count);
+                }));
+
+  bench::report("find_first_none, scalar loop", rows, bench::best_of(5, [&] {
+                  std::size_t i = 0;
+                  while (i < rows && dense[i] != -1) {
+                    ++i;
+                  }
+                  bench::do_not_optimize(i);
+                }));
+  bench::report("find_first_none, SentinelView", rows,
+                bench::best_of(5, [&] { bench::do_not_optimize(dense_view.find_first_none()); }));
+
+  bench::report("some_bits, scalar loop", rows, bench::best_of(5, [&] {
+                  std::vector<std::uint64_t> bits((rows + 63) / 64);
+                  for (std::size_t i = 0; i < rows; ++i) {
+                    bits[i / 64] |= std::uint64_t{raw[i] != -1} << (i % 64);
+                  }
+                  bench::do_not_optimize(bits.data());
+                }));
+  bench::report("some_bits, SentinelView", rows,
+                bench::best_of(5, [&] { bench::do_not_optimize(view.some_bits().data()); }));
+
+  bench::report("to_column, push_back", rows, bench::best_of(5, [&] {
+                  navp::OptionColumn<std::int32_t> column;
+                  for (auto v : raw) {
+                    v == -1 ? column.push_none() : void(column.emplace_back(v));
+                  }
+                  bench::do_not_optimize(column.size());
+                }));
+  bench::report("to_column, SentinelView", rows,
+                bench::best_of(5, [&] { bench::do_not_optimize(view.to_column().size()); }));
+}
@@ -0,0 +1,112 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "static_map.hpp"
+
+namespace bench = navp::bench;
+
+// N configuration keys "service.NNNN.port" built by the compiler, with the static map over them
+template <std::size_t N>
+struct Config {
+  static constexpr std::size_t key_len = 17;
+
+  static constexpr auto chars = [] {
+    std::array<char, N * key_len> buf{};
+    for (std::size_t i = 0; i < N; ++i) {
+      std::string_view pattern = "service.0000.port";
+      for (std::size_t j = 0; j < key_len; ++j) {
+        buf[i * key_len + j] = pattern[j];
+      }
+      for (std::size_t j = 0, v = i; j < 4; ++j, v /= 10) {
+        buf[i * key_len + 11 - j] = static_cast<char>('0' + v % 10);
+      }
+    }
+    return buf;
+  }();
+
+  static constexpr auto entries = [] {
+    std::array<std::pair<std::string_view, int>, N> e{};
+    for (std::size_t i = 0; i < N; ++i) {
+      e[i] = {std::string_view(chars.data() + i * key_len, key_len), static_cast<int>(8000 + i)};
+    }
+    return e;
+  }();
+
+  static constexpr auto map = navp::make_static_map(entries);
+};
+
+// heterogeneous lookup, so probing with a string_view does not build a std::string
+struct string_hash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+template <std::size_t N>
+static void run() {
+  using C = Config<N>;
+  char label[64];
+
+  // startup: the unordered_map is built and allocated at run time, the static map is already in the binary
+  std::snprintf(label, sizeof label, "startup, %zu keys, unordered_map", N);
+  bench::report(label, 1, bench::best_of(50, [&] {
+                  std::unordered_map<std::string, int, string_hash, std::equal_to<>> m(C::entries.begin(),
+                                                                                        C::entries.end());
+                  bench::do_not_optimize(m.size());
+                }));
+  std::printf("%-40s %12zu bytes, built at compile time\n", "startup, static map", sizeof(C::map));
+
+  // lookups: a random mix of the keys, then keys that are not there
+  std::unordered_map<std::string, int, string_hash, std::equal_to<>> strings(C::entries.begin(), C::entries.end());
+  std::unordered_map<std::string_view, int> views(C::entries.begin(), C::entries.end());
+  constexpr std::size_t probes = 1 << 20;
+  std::mt19937 rng(42);
+  std::vector<std::string_view> hits(probes), misses(probes);
+  std::vector<std::string> miss_storage(N);
+  for (std::size_t i = 0; i < N; ++i) {
+    miss_storage[i] = std::string(C::entries[i].first) + "s";
+  }
+  for (std::size_t i = 0; i < probes; ++i) {
+    hits[i] = C::entries[rng() % N].first;
+    misses[i] = miss_storage[rng() % N];
+  }
+
+  auto measure = [&](const char* what, const std::vector<std::string_view>& keys, auto&& find) {
+    std::snprintf(label, sizeof label, "%s, %zu keys", what, N);
+    bench::report(label, probes, bench::best_of(5, [&] {
+                    long sum = 0;
+                    for (auto k : keys) {
+                      sum += find(k);
+                    }
+                    bench::do_not_optimize(sum);
+                  }));
+  };
+  auto in_static = [](std::string_view k) { return C::map.find(k).unwrap_or(0); };
+  auto in_strings = [&](std::string_view k) {
+    auto it = strings.find(k);
+    return it == strings.end() ? 0 : it->second;
+  };
+  auto in_views = [&](std::string_view k) {
+    auto it = views.find(k);
+    return it == views.end() ? 0 : it->second;
+  };
+  measure("hit, static map", hits, in_static);
+  measure("hit, unordered_map<string>", hits, in_strings);
+  measure("hit, unordered_map<string_view>", hits, in_views);
+  measure("miss, static map", misses, in_static);
+  measure("miss, unordered_map<string>", misses, in_strings);
+  measure("miss, unordered_map<string_view>", misses, in_views);
+}
+
+int main() {
+  run<16>();
+  run<256>();
+  run<2048>();
+}
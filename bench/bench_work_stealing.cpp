@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "thread_pool.hpp"
+
+using navp::TaskGroup;
+using navp::ThreadPool;
+namespace bench = navp::bench;
+
+static long fib_seq(int n) { return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2); }
+
+// no cutoff on purpose, every call is a task, so the time is dominated by spawn/pop/steal cost
+static long fib_par(ThreadPool& pool, int n) {
+  if (n < 2) return n;
+  long a = 0;
+  TaskGroup group(pool);
+  group.run([&] { a = fib_par(pool, n - 1); });
+  long b = fib_par(pool, n - 2);
+  group.wait();
+  return a + b;
+}
+
+static void quicksort_par(ThreadPool& pool, int* first, int* last) {
+  if (last - first < 2048) {
+    std::sort(first, last);
+    return;
+  }
+  int pivot = first[(last - first) / 2];
+  int* mid1 = std::partition(first, last, [pivot](int x) { return x < pivot; });
+  int* mid2 = std::partition(mid1, last, [pivot](int x) { return !(pivot < x); });
+  TaskGroup group(pool);
+  group.run([&] { quicksort_par(pool, first, mid1); });
+  quicksort_par(pool, mid2, last);
+  group.wait();
+}
+
+int main() {
+  constexpr int n = 25;
+  const double calls = 2.0 * double(fib_seq(n + 1)) - 1;  // number of fib invocations
+  double seq = bench::best_of(3, [&] { bench::do_not_optimize(fib_seq(n)); });
+  bench::report("fib sequential", calls, seq);
+  for (std::size_t threads : {1u, 2u, 4u, 8u}) {
+    ThreadPool pool(threads);
+    double par = bench::best_of(3, [&] { bench::do_not_optimize(fib_par(pool, n)); });
+    char name[64];
+    std::snprintf(name, sizeof name, "fib fork-join %zut (steals %llu)", threads,
+                  static_cast<unsigned long long>(pool.steal_count()));
+    bench::report(name, calls, par);
+  }
+
+  std::vector<int> input(1 << 22);
+  std::mt19937 rng(42);
+  for (auto& x : input) x = static_cast<int>(rng());
+  std::vector<int> data;
+  double sort_seq = bench::best_of(3, [&] {
+    data = input;
+    std::sort(data.begin(), data.end());
+  });
+  bench::report("quicksort std::sort", double(input.size()), sort_seq);
+  for (std::size_t threads : {1u, 2u, 4u, 8u}) {
+    ThreadPool pool(threads);
+    double par = bench::best_of(3, [&] {
+      data = input;
+      quicksort_par(pool, data.data(), data.data() + data.size());
+    });
+    char name[64];
+    std::snprintf(name, sizeof name, "quicksort fork-join %zut (steals %llu)", threads,
+                  static_cast<unsigned long long>(pool.steal_count()));
+    bench::report(name, double(input.size()), par);
+  }
+}
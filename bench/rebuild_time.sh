@@ -0,0 +1,68 @@
+#!/bin/sh
+# full rebuild time of a synthetic project of N translation units that all use Option,
+# once including option.hpp and once importing navp.option (the module build is counted in its total)
+# usage: bench/rebuild_time.sh [N] [jobs]
+# CXX defaults to g++, MODULE_FLAGS to gcc's -fmodules-ts, CXXFLAGS may add -DNAVP_OPTION_CPPTRACE with cpptrace's include path
+set -e
+N=${1:-500}
+JOBS=${2:-$(nproc)}
+CXX=${CXX:-g++}
+MODULE_FLAGS=${MODULE_FLAGS:--fmodules-ts}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# gen_tu <i> <line making Option visible>
+# the units include nothing else and stay with flat Options: gcc 12 cannot yet mix an import with textual standard
+# headers in one unit, nor reach placement new from the module for Option<Option<T>>
+gen_tu() {
+  cat <<TU
+$2
+namespace tu_$1 {
+struct Row {
+  int id;
+  double score;
+};
+navp::Option<Row> find(const Row* rows, int n, int id) {
+  for (int i = 0; i < n; ++i) {
+    if (rows[i].id == id) {
+      return rows[i];
+    }
+  }
+  return navp::None;
+}
+double score_of(const Row* rows, int n, int id) {
+  auto row = find(rows, n, id);
+  return row.is_some() ? row.unwrap().score : -1.0;
+}
+navp::Option<int> digit(char c) { return c >= '0' && c <= '9' ? navp::Option<int>(c - '0') : navp::Option<int>(navp::None); }
+int digit_or(char c, int fallback) { return digit(c).unwrap_or(fallback); }
+}  // namespace tu_$1
+TU
+}
+
+now() { date +%s.%N; }
+
+mkdir -p "$WORK/header" "$WORK/module"
+i=0
+while [ "$i" -lt "$N" ]; do
+  gen_tu "$i" '#include "option.hpp"' > "$WORK/header/tu_$i.cpp"
+  gen_tu "$i" 'import navp.option;' > "$WORK/module/tu_$i.cpp"
+  i=$((i + 1))
+done
+
+cd "$WORK/header"
+start=$(now)
+ls tu_*.cpp | xargs -P "$JOBS" -I{} $CXX -std=c++23 $CXXFLAGS -I"$ROOT" -c {} -o {}.o
+header=$(awk "BEGIN { print $(now) - $start }")
+
+cd "$WORK/module"
+start=$(now)
+$CXX -std=c++23 $MODULE_FLAGS -x c++ -I"$ROOT" -c "$ROOT/option.cppm" -o option.o
+$CXX -std=c++23 $MODULE_FLAGS $CXXFLAGS -c "$ROOT/option_module.cpp" -o option_module.o
+ls tu_*.cpp | xargs -P "$JOBS" -I{} $CXX -std=c++23 $MODULE_FLAGS -c {} -o {}.o
+module=$(awk "BEGIN { print $(now) - $start }")
+
+echo "$N translation units, $JOBS jobs, $CXX"
+echo "#include \"option.hpp\"   : ${header} s"
+echo "import navp.option;     : ${module} s"
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace navp::details {
+
+// fixed instead of std::hardware_destructive_interference_size, which is not abi stable
+inline constexpr std::size_t cache_line_size = 64;
+
+// spin-wait hint
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+}  // namespace navp::details
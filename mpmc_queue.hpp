@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+#include "concurrency.hpp"
+#include "option.hpp"
+
+namespace navp {
+
+// bounded multi-producer multi-consumer ring queue (dmitry vyukov's design)
+template <typename T>
+class MpmcQueue {
+  static_assert(std::is_nothrow_move_constructible_v<T>, "MpmcQueue requires a nothrow move constructible T");
+
+ public:
+  // capacity is rounded up to a power of two
+  explicit MpmcQueue(std::size_t capacity)
+      : _m_mask(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+        _m_cells(std::make_unique<Cell[]>(_m_mask + 1)) {
+    for (std::size_t i = 0; i <= _m_mask; ++i) {
+      _m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  ~MpmcQueue() {
+    auto pos = _m_dequeue_pos.load(std::memory_order_relaxed);
+    auto end = _m_enqueue_pos.load(std::memory_order_relaxed);
+    for (; pos != end; ++pos) {
+      std::destroy_at(_m_cells[pos & _m_mask].value());
+    }
+  }
+
+  constexpr std::size_t capacity() const noexcept { return _m_mask + 1; }
+
+  // try_emplace, returns false when the queue is full
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args...>
+  bool try_emplace(Args&&... args) {
+    if constexpr (!std::is_nothrow_constructible_v<T, Args...>) {
+      // a throwing constructor must not run after a cell has been claimed
+      return try_emplace(T(std::forward<Args>(args)...));
+    } else {
+      Cell* cell = _m_claim(_m_enqueue_pos, 0);
+      if (cell == nullptr) {
+        return false;
+      }
+      auto pos = cell->sequence.load(std::memory_order_relaxed);
+      ::new (static_cast<void*>(cell->storage)) T(std::forward<Args>(args)...);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+  }
+
+  // try_push
+  bool try_push(const T& val) { return try_emplace(val); }
+  bool try_push(T&& val) { return try_emplace(std::move(val)); }
+
+  // try_pop, the result is constructed straight from the cell, T need not be default constructible
+  // a pointer-like T comes back in a Tagged option, a pushed null is Some(null) rather than None
+  details::element_option_t<T> try_pop() noexcept {
+    Cell* cell = _m_claim(_m_dequeue_pos, 1);
+    if (cell == nullptr) {
+      return None;
+    }
+    _ReleaseGuard guard{cell, cell->sequence.load(std::memory_order_relaxed) + _m_mask};
+    return details::element_option_t<T>(std::in_place, std::move(*cell->value()));
+  }
+
+ private:
+  struct alignas(details::cache_line_size) Cell {
+    std::atomic<std::size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  // destroys the popped value and hands the cell back to producers after the result is built
+  struct _ReleaseGuard {
+    Cell* cell;
+    std::size_t next;
+
+    ~_ReleaseGuard() {
+      std::destroy_at(cell->value());
+      cell->sequence.store(next, std::memory_order_release);
+    }
+  };
+
+  // claim the cell at `pos`, whose sequence equals pos + lag once it is ready for us
+  Cell* _m_claim(std::atomic<std::size_t>& pos_ref, std::size_t lag) noexcept {
+    auto pos = pos_ref.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell* cell = &_m_cells[pos & _m_mask];
+      auto seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + lag);
+      if (diff == 0) {
+        if (pos_ref.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return cell;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        pos = pos_ref.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  const std::size_t _m_mask;
+  const std::unique_ptr<Cell[]> _m_cells;
+  alignas(details::cache_line_size) std::atomic<std::size_t> _m_enqueue_pos{0};
+  alignas(details::cache_line_size) std::atomic<std::size_t> _m_dequeue_pos{0};
+};
+
+}  // namespace navp
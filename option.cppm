@@ -0,0 +1,27 @@
+// navp.option, the named module of option.hpp: exports Option, Some, None, option_error,
+// the representation policies (the Boxed storage included) and the niche_traits customization point
+// the standard headers are included ahead of the purview, so the include in it only brings navp's own declarations,
+// and cpptrace, when enabled, is left to option_module.cpp
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+export module navp.option;
+
+#define NAVP_OPTION_MODULE
+#include "option.hpp"
+#include "option_boxed.hpp"
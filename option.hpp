@@ -1,61 +1,685 @@
 #pragma once
 
-#include <cpptrace/cpptrace.hpp>
+// NAVP_OPTION_MODULE is set by option.cppm, which includes this header inside the navp.option module:
+// the public names are exported and the unwrap failure path is defined in option_module.cpp,
+// so cpptrace stays out of every importer
+// NAVP_OPTION_LIBRARY is set for the targets linking the navp_option library (option_library.cpp):
+// the unwrap failure path is compiled there once; Option itself is not, every member is constexpr and so inline,
+// and an extern template would not keep a unit from instantiating it
+// NAVP_OPTION_UNWRAP_DEFINITION is set by option_library.cpp and option_module.cpp, the units that compile the
+// unwrap failure path below out of line; option_module.cpp sets NAVP_OPTION_MODULE as well and only takes that
+// part, the rest comes from the module it implements
+// NAVP_OPTION_CPPTRACE (the xmake option cpptrace) makes a failed unwrap print its stack trace with cpptrace
+// when no unwrap hook is set; without it this header needs nothing but the standard library
+#ifdef NAVP_OPTION_MODULE
+#define NAVP_EXPORT export
+#else
+#define NAVP_EXPORT
+#endif
+
+#if defined(NAVP_OPTION_MODULE) || defined(NAVP_OPTION_LIBRARY)
+#define NAVP_UNWRAP_INLINE
+#else
+#define NAVP_UNWRAP_INLINE inline
+#endif
+
+#if !(defined(NAVP_OPTION_MODULE) && defined(NAVP_OPTION_UNWRAP_DEFINITION))
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
 #include <variant>
 
+#if defined(NAVP_OPTION_CPPTRACE) && !defined(NAVP_OPTION_MODULE) && \
+    (!defined(NAVP_OPTION_LIBRARY) || defined(NAVP_OPTION_UNWRAP_DEFINITION))
+#include <cpptrace/cpptrace.hpp>
+#endif
+
 namespace navp {
 
-class option_error : public std::runtime_error {
+NAVP_EXPORT class option_error : public std::runtime_error {
   using std::runtime_error::runtime_error;
 };
 
-template <typename T>
+// unwrap_hook_t, called with the message when unwrap or expected finds a None, just before option_error is thrown
+NAVP_EXPORT using unwrap_hook_t = void (*)(const char* msg);
+
+}  // namespace navp
+
+#endif  // !(NAVP_OPTION_MODULE && NAVP_OPTION_UNWRAP_DEFINITION)
+
+// unwrap_hook, the slot of the installed hook; unwrap_failed, the cold path of unwrap and expected on a None:
+// runs the hook, or prints the caller's stack trace with cpptrace when it is enabled, then throws
+// the one definition, inline in header mode, otherwise compiled once by the unit setting NAVP_OPTION_UNWRAP_DEFINITION
+namespace navp::details {
+
+#if !(defined(NAVP_OPTION_MODULE) || defined(NAVP_OPTION_LIBRARY)) || defined(NAVP_OPTION_UNWRAP_DEFINITION)
+NAVP_UNWRAP_INLINE std::atomic<unwrap_hook_t>& unwrap_hook() noexcept {
+  static std::atomic<unwrap_hook_t> hook{nullptr};
+  return hook;
+}
+
+[[noreturn, gnu::cold, gnu::noinline]] NAVP_UNWRAP_INLINE void unwrap_failed(const char* msg) {
+  if (auto hook = unwrap_hook().load(std::memory_order_acquire); hook != nullptr) {
+    hook(msg);
+  } else {
+#ifdef NAVP_OPTION_CPPTRACE
+    cpptrace::generate_trace(2).print_with_snippets();
+#endif
+  }
+  throw option_error(msg);
+}
+#else
+std::atomic<unwrap_hook_t>& unwrap_hook() noexcept;
+[[noreturn]] void unwrap_failed(const char* msg);
+#endif
+
+}  // namespace navp::details
+
+#if !(defined(NAVP_OPTION_MODULE) && defined(NAVP_OPTION_UNWRAP_DEFINITION))
+
+namespace navp {
+
+namespace details {
+
+// called by a None unwrap in constant evaluation only, so never defined: the call is not a constant expression
+// and the program fails to compile with this name in the diagnostic
+void unwrap_of_none_in_constant_expression() noexcept;
+
+}  // namespace details
+
+// set_unwrap_hook, installs the hook of every later failed unwrap, nullptr restores the default; returns the old one
+NAVP_EXPORT inline unwrap_hook_t set_unwrap_hook(unwrap_hook_t hook) noexcept {
+  return details::unwrap_hook().exchange(hook, std::memory_order_acq_rel);
+}
+
+// representation policies, the second template parameter of Option
+// Compact  : None lives in a spare state of T when niche_traits<T> has one, otherwise Tagged; the default
+// Tagged   : the payload plus a discriminant byte
+// NanBoxed : float/double only, None is one reserved signaling nan, so Option<double, NanBoxed> is 8 bytes
+// Sentinel<V> : None is the value V of T, which Some may then not hold, e.g. Option<int, Sentinel<INT_MIN>>
+//               is layout compatible with int, so an array of it can be handed to code expecting raw ints
+// Packed   : bool only, None and the spare states are the byte values 2..255, so Option<bool, Packed> is one byte;
+//            telling them apart reads the object representation, so it is run time only, unlike the default Tagged
+// Boxed    : Some lives in a block from a pool of its size, None is a null pointer, for large payloads that are
+//            mostly None; moving the Option moves the pointer and leaves the source None; include option_boxed.hpp
+NAVP_EXPORT struct Compact {};
+NAVP_EXPORT struct Tagged {};
+NAVP_EXPORT struct NanBoxed {};
+NAVP_EXPORT struct Packed {};
+NAVP_EXPORT struct Boxed {};
+NAVP_EXPORT template <auto V>
+struct Sentinel {};
+
+NAVP_EXPORT template <typename T, typename Repr = Compact>
 class Option;
 
+// niche_traits, spare states of T that an enclosing Option can use for None
+//   count    : number of spare states
+//   make(i)  : a T in spare state i, i < count
+//   index(v) : i when v is in spare state i, count when v holds a real value
+// copying or moving a T must keep its spare state
+NAVP_EXPORT template <typename T>
+struct niche_traits {
+  static constexpr std::size_t count = 0;
+};
+
+// spare_field, niche_traits for a T that hands one of its integral members to Option
+// T must be default constructible with that member at 0, Option uses the other values of the member,
+// so an over-aligned T keeps its size instead of growing by a whole alignment step for the tag:
+//   struct alignas(64) Stats { std::uint64_t hits[7]; std::uint8_t option_tag = 0; };
+//   template <> struct navp::niche_traits<Stats> : navp::spare_field<&Stats::option_tag> {};
+// raw tail padding is not usable for this, copies of T are free to clobber it
+NAVP_EXPORT template <auto Member>
+struct spare_field;
+
+template <typename T, typename F, F T::*Member>
+struct spare_field<Member> {
+  static_assert(std::is_integral_v<F> && !std::is_same_v<F, bool>, "the spare field must be an integer");
+
+  static constexpr std::size_t count = static_cast<std::size_t>(std::numeric_limits<F>::max());
+
+  static constexpr T make(std::size_t i) noexcept(std::is_nothrow_default_constructible_v<T>) {
+    T val{};
+    val.*Member = static_cast<F>(i + 1);
+    return val;
+  }
+  static constexpr std::size_t index(const T& val) noexcept {
+    return val.*Member == 0 ? count : static_cast<std::size_t>(val.*Member) - 1;
+  }
+};
+
+// enum_max, the largest enumerator of E, every underlying value above it is a spare state for Option<E>
+// picked up from an enumerator named max_value, otherwise specialize it:
+//   template <> struct navp::enum_max<Color> { static constexpr Color value = Color::Blue; };
+NAVP_EXPORT template <typename E>
+struct enum_max {};
+
+template <typename E>
+  requires std::is_enum_v<E> && requires { E::max_value; }
+struct enum_max<E> {
+  static constexpr E value = E::max_value;
+};
+
+// only enums with a fixed underlying type, the others may not hold values past their enumerators
+template <typename E>
+  requires std::is_enum_v<E> && requires {
+    enum_max<E>::value;
+    E{std::underlying_type_t<E>{}};
+  }
+struct niche_traits<E> {
+  using _Underlying = std::underlying_type_t<E>;
+  static constexpr auto _s_max = static_cast<_Underlying>(enum_max<E>::value);
+
+  // unsigned wrap-around gives the exact distance for signed types as well
+  static constexpr std::size_t count =
+      static_cast<std::size_t>(std::numeric_limits<_Underlying>::max()) - static_cast<std::size_t>(_s_max);
+
+  static constexpr E make(std::size_t i) noexcept {
+    return static_cast<E>(static_cast<_Underlying>(static_cast<std::size_t>(_s_max) + 1 + i));
+  }
+  static constexpr std::size_t index(E val) noexcept {
+    auto raw = static_cast<_Underlying>(val);
+    return raw > _s_max ? static_cast<std::size_t>(raw) - static_cast<std::size_t>(_s_max) - 1 : count;
+  }
+};
+
+// null_niche, the null state of a pointer-like T is its single spare state
+// so Some(null) is not representable: it asserts in debug builds, pick Tagged (Option<int*, Tagged>) when it is needed
+// a moved-from unique_ptr is null, so a moved-from Option<std::unique_ptr<U>> reads as None
+template <typename T>
+struct null_niche {
+  static constexpr std::size_t count = 1;
+
+  static constexpr T make(std::size_t) noexcept { return T(); }
+  static constexpr std::size_t index(const T& val) noexcept { return val == nullptr ? 0 : count; }
+};
+
+template <typename T>
+struct niche_traits<T*> : null_niche<T*> {};
+
+template <typename T, typename D>
+  requires std::is_nothrow_default_constructible_v<D>
+struct niche_traits<std::unique_ptr<T, D>> : null_niche<std::unique_ptr<T, D>> {};
+
+template <typename T>
+struct niche_traits<std::shared_ptr<T>> : null_niche<std::shared_ptr<T>> {};
+
+// no null_niche for span or string_view: a null data() is a valid empty view (an empty vector gives one),
+// so they take the Tagged layout
+
 namespace details {
 
 struct NoneType {
   explicit NoneType() = default;
 };
 
+struct niche_t {
+  explicit niche_t() = default;
+};
+
+struct bind_t {
+  explicit bind_t() = default;
+};
+
+struct from_fn_t {
+  explicit from_fn_t() = default;
+};
+
+template <typename T, typename Repr>
+struct option_promise;
+
+// storage behind Option, one specialization per representation
+// each one starts out None and provides _m_is_some, _m_value, _m_emplace and _m_reset,
+// plus _s_niche_count spare states for an enclosing Option (niche_t constructor and _m_niche_index)
+// the from_fn_t constructor and _m_emplace_with initialize the payload straight from the prvalue f returns
+// a storage whose Some is the payload byte for byte says so with _s_payload_bytes, see stores_payload_bytes
+template <typename T, typename Repr>
+struct option_storage;
+
+template <typename T>
+struct option_storage<T, Tagged> {
+  // 0 is Some, 1 is None, the rest are spare states lent to an enclosing Option
+  static constexpr unsigned char _s_some = 0;
+  static constexpr unsigned char _s_none = 1;
+  static constexpr std::size_t _s_niche_count = 254;
+
+  constexpr option_storage() noexcept : _m_empty(), _m_tag(_s_none) {}
+  constexpr option_storage(niche_t, std::size_t i) noexcept
+      : _m_empty(), _m_tag(static_cast<unsigned char>(i + _s_none + 1)) {}
+  template <typename... Args>
+  constexpr explicit option_storage(std::in_place_t, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : _m_payload(std::forward<Args>(args)...), _m_tag(_s_some) {}
+  template <typename F>
+  constexpr option_storage(from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _m_payload(std::invoke(std::forward<F>(f))), _m_tag(_s_some) {}
+
+  constexpr option_storage(const option_storage&)
+    requires std::is_trivially_copy_constructible_v<T>
+  = default;
+  constexpr option_storage(const option_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+    requires(std::is_copy_constructible_v<T> && !std::is_trivially_copy_constructible_v<T>)
+      : _m_empty(), _m_tag(other._m_tag) {
+    if (other._m_is_some()) {
+      std::construct_at(std::addressof(_m_payload), other._m_payload);
+    }
+  }
+
+  constexpr option_storage(option_storage&&)
+    requires std::is_trivially_move_constructible_v<T>
+  = default;
+  constexpr option_storage(option_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    requires(std::is_move_constructible_v<T> && !std::is_trivially_move_constructible_v<T>)
+      : _m_empty(), _m_tag(other._m_tag) {
+    if (other._m_is_some()) {
+      std::construct_at(std::addressof(_m_payload), std::move(other._m_payload));
+    }
+  }
+
+  constexpr option_storage& operator=(const option_storage&)
+    requires(std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T> &&
+             std::is_trivially_destructible_v<T>)
+  = default;
+  constexpr option_storage& operator=(const option_storage& other) noexcept(
+      std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>)
+    requires(std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T> &&
+             !(std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T> &&
+               std::is_trivially_destructible_v<T>))
+  {
+    _m_assign(other._m_tag, other._m_payload);
+    return *this;
+  }
+
+  constexpr option_storage& operator=(option_storage&&)
+    requires(std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T> &&
+             std::is_trivially_destructible_v<T>)
+  = default;
+  constexpr option_storage& operator=(option_storage&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+    requires(std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+             !(std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T> &&
+               std::is_trivially_destructible_v<T>))
+  {
+    _m_assign(other._m_tag, std::move(other._m_payload));
+    return *this;
+  }
+
+  constexpr ~option_storage()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+  constexpr ~option_storage() {
+    if (_m_is_some()) {
+      std::destroy_at(std::addressof(_m_payload));
+    }
+  }
+
+  constexpr bool _m_is_some() const noexcept { return _m_tag == _s_some; }
+  constexpr std::size_t _m_niche_index() const noexcept {
+    return _m_tag > _s_none ? _m_tag - _s_none - 1 : _s_niche_count;
+  }
+
+  constexpr const T& _m_value() const noexcept { return _m_payload; }
+  constexpr T& _m_value() noexcept { return _m_payload; }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    _m_reset();
+    std::construct_at(std::addressof(_m_payload), std::forward<Args>(args)...);
+    _m_tag = _s_some;
+  }
+
+  // placement new is what elides the move, construct_at would take f's result as an argument,
+  // constant evaluation only allows construct_at, so there a T that cannot move is run time only
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    _m_reset();
+    if constexpr (std::is_move_constructible_v<T>) {
+      if consteval {
+        std::construct_at(std::addressof(_m_payload), std::invoke(std::forward<F>(f)));
+        _m_tag = _s_some;
+        return;
+      }
+    }
+    ::new (static_cast<void*>(std::addressof(_m_payload))) T(std::invoke(std::forward<F>(f)));
+    _m_tag = _s_some;
+  }
+
+  constexpr void _m_reset() noexcept {
+    if (_m_is_some()) {
+      std::destroy_at(std::addressof(_m_payload));
+    }
+    _m_tag = _s_none;
+  }
+
+  // the other side's payload is only touched when its tag says Some
+  template <typename U>
+  constexpr void _m_assign(unsigned char tag, U&& payload) {
+    if (tag != _s_some) {
+      _m_reset();
+      _m_tag = tag;
+    } else if (_m_is_some()) {
+      _m_payload = std::forward<U>(payload);
+    } else {
+      std::construct_at(std::addressof(_m_payload), std::forward<U>(payload));
+      _m_tag = _s_some;
+    }
+  }
+
+  union {
+    NoneType _m_empty;
+    T _m_payload;
+  };
+  unsigned char _m_tag;
+};
+
+// just the T, None is spare state 0 of Niche and the rest are passed on
+template <typename T, typename Niche>
+struct niche_storage {
+  using _Niche = Niche;
+  static constexpr std::size_t _s_niche_count = _Niche::count - 1;
+  static constexpr bool _s_payload_bytes = true;
+
+  constexpr niche_storage() noexcept : _m_payload(_Niche::make(0)) {}
+  constexpr niche_storage(niche_t, std::size_t i) noexcept : _m_payload(_Niche::make(i + 1)) {}
+  template <typename... Args>
+  constexpr explicit niche_storage(std::in_place_t, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : _m_payload(std::forward<Args>(args)...) {
+    assert(_m_is_some() && "a spare state of T cannot be stored as Some");
+  }
+  template <typename F>
+  constexpr niche_storage(from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _m_payload(std::invoke(std::forward<F>(f))) {
+    assert(_m_is_some() && "a spare state of T cannot be stored as Some");
+  }
+
+  constexpr bool _m_is_some() const noexcept { return _Niche::index(_m_payload) == _Niche::count; }
+  constexpr std::size_t _m_niche_index() const noexcept {
+    auto i = _Niche::index(_m_payload);
+    return i == 0 || i == _Niche::count ? _s_niche_count : i - 1;
+  }
+
+  constexpr const T& _m_value() const noexcept { return _m_payload; }
+  constexpr T& _m_value() noexcept { return _m_payload; }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      std::destroy_at(std::addressof(_m_payload));
+      std::construct_at(std::addressof(_m_payload), std::forward<Args>(args)...);
+    } else {
+      _m_payload = T(std::forward<Args>(args)...);
+    }
+    assert(_m_is_some() && "a spare state of T cannot be stored as Some");
+  }
+
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    _m_emplace(std::invoke(std::forward<F>(f)));
+  }
+
+  constexpr void _m_reset() noexcept { _m_payload = _Niche::make(0); }
+
+  T _m_payload;
+};
+
+// Compact over a T with spare states
+template <typename T>
+struct option_storage<T, Compact> : niche_storage<T, niche_traits<T>> {
+  using niche_storage<T, niche_traits<T>>::niche_storage;
+};
+
+// Sentinel<V>, the single spare state is the value V itself
+template <typename T, auto V>
+struct sentinel_niche {
+  static constexpr std::size_t count = 1;
+
+  static constexpr T make(std::size_t) noexcept { return static_cast<T>(V); }
+  static constexpr std::size_t index(const T& val) noexcept { return val == static_cast<T>(V) ? 0 : count; }
+};
+
+template <typename T, auto V>
+struct option_storage<T, Sentinel<V>> : niche_storage<T, sentinel_niche<T, V>> {
+  static_assert(std::is_scalar_v<T>, "Sentinel applies to integers, enums and pointers");
+  static_assert(!std::is_floating_point_v<T>, "a nan sentinel never compares equal, use NanBoxed");
+
+  using niche_storage<T, sentinel_niche<T, V>>::niche_storage;
+};
+
+// bool only uses the byte values 0 and 1, None is 2 and 3..255 are lent to an enclosing Option
+// telling them apart reads the object representation, which constant evaluation cannot do,
+// so this layout is opt in, the default Option<bool> is Tagged and stays usable in constant expressions
+template <typename T>
+struct option_storage<T, Packed> {
+  static_assert(std::is_same_v<T, bool>, "Packed only applies to bool");
+};
+
+template <>
+struct option_storage<bool, Packed> {
+  static constexpr unsigned char _s_none = 2;
+  static constexpr std::size_t _s_niche_count = 253;
+
+  constexpr option_storage() noexcept : _m_raw(_s_none) {}
+  constexpr option_storage(niche_t, std::size_t i) noexcept : _m_raw(static_cast<unsigned char>(i + _s_none + 1)) {}
+  template <typename... Args>
+  constexpr explicit option_storage(std::in_place_t, Args&&... args) noexcept
+      : _m_payload(std::forward<Args>(args)...) {}
+  template <typename F>
+  constexpr option_storage(from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _m_payload(std::invoke(std::forward<F>(f))) {}
+
+  bool _m_is_some() const noexcept { return _m_repr() < _s_none; }
+  std::size_t _m_niche_index() const noexcept {
+    auto repr = _m_repr();
+    return repr > _s_none ? repr - _s_none - 1 : _s_niche_count;
+  }
+
+  const bool& _m_value() const noexcept { return _m_payload; }
+  bool& _m_value() noexcept { return _m_payload; }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept {
+    _m_payload = bool(std::forward<Args>(args)...);
+  }
+
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    _m_payload = std::invoke(std::forward<F>(f));
+  }
+
+  constexpr void _m_reset() noexcept { _m_raw = _s_none; }
+
+  unsigned char _m_repr() const noexcept {
+    unsigned char repr;
+    std::memcpy(&repr, this, 1);
+    return repr;
+  }
+
+  union {
+    unsigned char _m_raw;
+    bool _m_payload;
+  };
+};
+
+// quiet nans keep the top mantissa bit set, so a signaling pattern with a private payload is free for None
+// the value is only ever moved as bits on the supported targets, x87-only builds would quiet it
+template <typename T>
+struct nan_box;
+template <>
+struct nan_box<float> {
+  using bits_type = std::uint32_t;
+  static constexpr bits_type none = 0x7f80'4e45u;
+};
+template <>
+struct nan_box<double> {
+  using bits_type = std::uint64_t;
+  static constexpr bits_type none = 0x7ff0'0000'4e4f'4e45ull;
+};
+
+template <typename T>
+struct option_storage<T, NanBoxed> {
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "NanBoxed only applies to float and double");
+
+  using _Box = nan_box<T>;
+
+  constexpr option_storage() noexcept : _m_payload(std::bit_cast<T>(_Box::none)) {}
+  template <typename... Args>
+  constexpr explicit option_storage(std::in_place_t, Args&&... args) noexcept
+      : _m_payload(std::forward<Args>(args)...) {
+    assert(_m_is_some() && "the reserved None nan cannot be stored as Some");
+  }
+  template <typename F>
+  constexpr option_storage(from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _m_payload(std::invoke(std::forward<F>(f))) {
+    assert(_m_is_some() && "the reserved None nan cannot be stored as Some");
+  }
+
+  static constexpr std::size_t _s_niche_count = 0;
+  static constexpr bool _s_payload_bytes = true;
+
+  constexpr bool _m_is_some() const noexcept { return std::bit_cast<typename _Box::bits_type>(_m_payload) != _Box::none; }
+
+  constexpr const T& _m_value() const noexcept { return _m_payload; }
+  constexpr T& _m_value() noexcept { return _m_payload; }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept {
+    _m_payload = T(std::forward<Args>(args)...);
+    assert(_m_is_some() && "the reserved None nan cannot be stored as Some");
+  }
+
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    _m_emplace(std::invoke(std::forward<F>(f)));
+  }
+
+  constexpr void _m_reset() noexcept { _m_payload = std::bit_cast<T>(_Box::none); }
+
+  T _m_payload;
+};
+
+// Option<T&>, the address of the referent, null is None
+// the payload accessors hand out T itself, so a const Option<T&> still refers to a mutable T, like a T*
+template <typename T>
+struct option_ref_storage {
+  static constexpr std::size_t _s_niche_count = 0;
+
+  constexpr option_ref_storage() noexcept : _m_ptr(nullptr) {}
+  template <typename U>
+  constexpr explicit option_ref_storage(std::in_place_t, U&& ref) noexcept : _m_ptr(std::addressof(ref)) {}
+  template <typename F>
+  constexpr option_ref_storage(from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _m_ptr(std::addressof(std::invoke(std::forward<F>(f)))) {}
+
+  constexpr bool _m_is_some() const noexcept { return _m_ptr != nullptr; }
+
+  constexpr T _m_value() const noexcept { return *_m_ptr; }
+
+  template <typename U>
+  constexpr void _m_emplace(U&& ref) noexcept {
+    _m_ptr = std::addressof(ref);
+  }
+
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    _m_ptr = std::addressof(std::invoke(std::forward<F>(f)));
+  }
+
+  constexpr void _m_reset() noexcept { _m_ptr = nullptr; }
+
+  std::remove_reference_t<T>* _m_ptr;
+};
+
 template <typename T, template <typename...> class Template>
 struct is_instance_of : std::false_type {};
 template <template <typename...> class Template, typename... Args>
 struct is_instance_of<Template<Args...>, Template> : std::true_type {};
 
-template <typename T>
-using not_tag = std::__not_<std::is_same<std::remove_cv<T>, NoneType>>;
+// T is built from an Option<U, R> as a whole, so converting its payload would drop a level of nesting
+// (std::optional's __converts_from_optional), arithmetic T is left out as every Option converts to bool,
+// and a reference only binds the Option itself, not a temporary made from it
+template <typename T, typename O>
+concept takes_option =
+    !std::is_arithmetic_v<std::remove_cvref_t<T>> &&
+    (!std::is_reference_v<T> || is_instance_of<std::remove_cvref_t<T>, Option>::value) &&
+    (std::is_constructible_v<T, O&> || std::is_constructible_v<T, const O&> || std::is_constructible_v<T, O&&> ||
+     std::is_constructible_v<T, const O&&> || std::is_convertible_v<O&, T> || std::is_convertible_v<const O&, T> ||
+     std::is_convertible_v<O&&, T> || std::is_convertible_v<const O&&, T>);
 
-}  // namespace details
+// a constructor argument that is a payload of T, not None, and an Option of any representation only when T takes it
+// checked first, so the is_constructible and is_convertible checks after it never see other Option arguments
+template <typename T, typename U>
+concept payload_arg = !std::is_same_v<std::remove_cvref_t<U>, NoneType> &&
+                      (!is_instance_of<std::remove_cvref_t<U>, Option>::value ||
+                       takes_option<T, std::remove_cvref_t<U>>);
+
+// an Option<T&> only binds to an lvalue whose address converts, never to a temporary made for the call
+template <typename T, typename U>
+concept binds_payload = !std::is_reference_v<T> || (std::is_lvalue_reference_v<U> &&
+                                                     std::is_convertible_v<std::remove_reference_t<U>*,
+                                                                           std::remove_reference_t<T>*>);
 
-constexpr details::NoneType None{};
+// f's result can be the payload, for Option<T&> only an lvalue that binds_payload accepts
+// a prvalue T is taken as is, is_constructible would ask for a move
+template <typename T, typename F>
+concept builds_payload = std::is_invocable_v<F> &&
+                         (std::is_same_v<std::invoke_result_t<F>, std::remove_cv_t<T>> ||
+                          std::is_constructible_v<T, std::invoke_result_t<F>>) &&
+                         binds_payload<T, std::invoke_result_t<F>>;
 
-template <typename _Tp, typename _Up>
-using __converts_from_option =
-    std::__or_<std::is_constructible<_Tp, const Option<_Up>&>, std::is_constructible<_Tp, Option<_Up>&>,
-               std::is_constructible<_Tp, const Option<_Up>&&>, std::is_constructible<_Tp, Option<_Up>&&>,
-               std::is_convertible<const Option<_Up>&, _Tp>, std::is_convertible<Option<_Up>&, _Tp>,
-               std::is_convertible<const Option<_Up>&&, _Tp>, std::is_convertible<Option<_Up>&&, _Tp>>;
+// Compact falls back to Tagged when T has no spare state
+// a reference is always a pointer, whatever the representation
+template <typename T, typename Repr>
+using option_storage_t = std::conditional_t<
+    std::is_reference_v<T>, option_ref_storage<T>,
+    std::conditional_t<std::is_same_v<Repr, Compact> && niche_traits<T>::count == 0,
+                       option_storage<T, Tagged>, option_storage<T, Repr>>>;
 
+// stores_payload_bytes, a Some of O is its payload byte for byte, so a run of Somes can be copied out as Ts
+// true for the niche, Sentinel and NanBoxed storages, never for a tag byte or a Boxed pointer, whatever the size
+template <typename O>
+inline constexpr bool stores_payload_bytes = false;
+template <typename T, typename Repr>
+inline constexpr bool stores_payload_bytes<Option<T, Repr>> =
+    requires { requires option_storage_t<T, Repr>::_s_payload_bytes; };
+
+// element_option_t, the Option a container hands a stored T back in
+// a null pointer-like T is a real element there, so those come back Tagged instead of in the null niche
 template <typename T>
-class Option : private std::variant<T, details::NoneType> {
- private:
-  template <typename _Up>
-  using __not_self = std::__not_<std::is_same<Option, std::__remove_cvref_t<_Up>>>;
+using element_option_t =
+    Option<T, std::conditional_t<std::is_base_of_v<null_niche<T>, niche_traits<T>>, Tagged, Compact>>;
+
+}  // namespace details
+
+NAVP_EXPORT inline constexpr details::NoneType None{};
 
-  template <typename... _Cond>
-  using _Requires = std::enable_if_t<std::__and_v<_Cond...>, bool>;
+template <typename T, typename Repr>
+class Option : private details::option_storage_t<T, Repr> {
+ private:
+  using _Base = details::option_storage_t<T, Repr>;
 
-  using _Base = std::variant<T, details::NoneType>;
+  friend struct niche_traits<Option>;
+  friend struct details::option_promise<T, Repr>;
 
  public:
+  using value_type = T;
+
   // operator ()
   constexpr operator bool() const noexcept { return is_some(); }
 
   // operator ==
-  template <typename U = T>
+  template <typename U = T, typename R>
     requires std::is_convertible<U, T>::value
-  constexpr bool operator==(const Option<U>& rhs) const noexcept(std::is_nothrow_constructible_v<U, T>) {
+  constexpr bool operator==(const Option<U, R>& rhs) const noexcept(std::is_nothrow_constructible_v<U, T>) {
     if (is_some() && rhs.is_some()) {
       return rhs.unwrap_unchecked() == _m_get_some_value();
     }
@@ -64,104 +688,95 @@ class Option : private std::variant<T, details::NoneType> {
   constexpr bool operator==(details::NoneType) const noexcept { return is_none(); }
 
   // operator |
-  template <typename U>
-  constexpr Option<U> operator|(const Option<U>& rhs) const noexcept {
-    return is_some() ? rhs : None;
+  template <typename U, typename R>
+  constexpr Option<U, R> operator|(const Option<U, R>& rhs) const noexcept {
+    if (is_some()) {
+      return rhs;
+    }
+    return None;
   }
-  template <typename U>
-  constexpr Option<U> operator|(Option<U>&& rhs) const noexcept {
-    return is_some() ? std::move(rhs) : None;
+  template <typename U, typename R>
+  constexpr Option<U, R> operator|(Option<U, R>&& rhs) const noexcept {
+    if (is_some()) {
+      return std::move(rhs);
+    }
+    return None;
   }
 
-  constexpr Option() noexcept : std::variant<T, details::NoneType>(details::NoneType{}) {}
+  constexpr Option() noexcept : _Base() {}
   constexpr Option(const Option&) noexcept = default;
   constexpr Option(Option&&) noexcept = default;
   constexpr Option& operator=(const Option&) noexcept = default;
   constexpr Option& operator=(Option&&) noexcept = default;
 
-  // copy/move constructor from U value
-  template <typename U = T, _Requires<__not_self<U>, details::not_tag<U>,
-                                      std::__not_<details::is_instance_of<std::__remove_cvref_t<U>, Option>>,
-                                      std::__not_<details::is_instance_of<std::__remove_cvref_t<U>, std::variant>>,
-                                      std::is_constructible<T, U>, std::is_convertible<U, T>> = true>
-  constexpr Option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>)
-      : std::variant<T, details::NoneType>(static_cast<T>(std::forward<U>(val))) {}
-
-  template <typename U = T, _Requires<__not_self<U>, details::not_tag<U>,
-                                      std::__not_<details::is_instance_of<std::__remove_cvref_t<U>, Option>>,
-                                      std::__not_<details::is_instance_of<std::__remove_cvref_t<U>, std::variant>>,
-                                      std::is_constructible<T, U>, std::__not_<std::is_convertible<U, T>>> = false>
-  explicit constexpr Option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>)
-      : std::variant<T, details::NoneType>(std::forward<U>(val)) {}
-
-  // copy/move constructor form Option<U>
-  template <typename U, _Requires<std::__not_<std::is_same<U, T>>, std::is_constructible<T, const U&>,
-                                  std::is_convertible<const U&, T>> = true>
-  constexpr Option(const Option<U>& other) noexcept(std::is_nothrow_convertible_v<T, const U&>) {
-    if (other.is_none()) {
-      *this = None;
-    } else {
-      this->template emplace<0>(other.unwrap());
-      // *this = T(other.unwrap());
-    }
-  }
+  // copy/move constructor from U value, explicit when U does not convert to T
+  template <typename U = T>
+    requires(!std::is_same_v<std::remove_cvref_t<U>, Option>) && details::payload_arg<T, U> &&
+            std::is_constructible_v<T, U> && details::binds_payload<T, U>
+  constexpr explicit(!std::is_convertible_v<U, T>) Option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>)
+      : _Base(std::in_place, std::forward<U>(val)) {}
 
-  template <typename U, _Requires<std::__not_<std::is_same<U, T>>, std::is_constructible<T, const U&>,
-                                  std::__not_<std::is_convertible<const U&, T>>> = false>
-  explicit constexpr Option(const Option<U>& other) noexcept(std::is_nothrow_convertible_v<T, const U&>) {
+  // copy/move constructor form Option<U> of any representation
+  // steps aside when T takes the Option<U> itself, Option<Option<int>>(Option<int>(None)) is Some(None)
+  template <typename U, typename R>
+    requires(!std::is_same_v<Option<U, R>, Option> && !details::takes_option<T, Option<U, R>> &&
+             std::is_constructible_v<T, const U&>)
+  constexpr explicit(!std::is_convertible_v<const U&, T>) Option(const Option<U, R>& other) noexcept(
+      std::is_nothrow_convertible_v<T, const U&>) {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = T(other.unwrap());
     }
   }
 
-  template <typename U,
-            _Requires<std::__not_<std::is_same<U, T>>, std::is_constructible<T, U>, std::is_convertible<U, T>> = true>
-  constexpr Option(Option<U>&& other) noexcept(std::is_nothrow_convertible_v<T, U>) {
+  template <typename U, typename R>
+    requires(!std::is_same_v<Option<U, R>, Option> && !details::takes_option<T, Option<U, R>> &&
+             std::is_constructible_v<T, U>)
+  constexpr explicit(!std::is_convertible_v<U, T>) Option(Option<U, R>&& other) noexcept(
+      std::is_nothrow_convertible_v<T, U>) {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
-      // *this = std::move(T(other.unwrap()));
-    }
-  }
-
-  template <typename U, _Requires<std::__not_<std::is_same<U, T>>, std::is_constructible<T, U>,
-                                  std::__not_<std::is_convertible<U, T>>> = false>
-  explicit constexpr Option(Option<U>&& other) noexcept(std::is_nothrow_convertible_v<T, U>) {
-    if (other.is_none()) {
-      *this = None;
-    } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = std::move(T(other.unwrap()));
     }
   }
 
   // construct in_place
-  template <typename... Args, _Requires<std::is_constructible<T, Args...>> = false>
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args...>
   explicit constexpr Option(std::in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
-      : std::variant<T, details::NoneType>(std::in_place_index_t<0>{}, std::forward<Args>(args)...) {}
+      : _Base(std::in_place, std::forward<Args>(args)...) {}
 
-  template <typename U, typename... Args,
-            _Requires<std::is_constructible<T, std::initializer_list<U>&, Args...>> = false>
+  template <typename U, typename... Args>
+    requires std::is_constructible_v<T, std::initializer_list<U>&, Args...>
   explicit constexpr Option(std::in_place_t, std::initializer_list<U> list, Args&&... args) noexcept(
       std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>)
-      : std::variant<T, details::NoneType>(std::in_place_index_t<0>{}, list, std::forward<Args>(args)...) {}
+      : _Base(std::in_place, list, std::forward<Args>(args)...) {}
+
+  // from_fn, Some of what f returns, which becomes the payload without a move: guaranteed copy elision
+  // carries f's prvalue into the storage, so T may be neither copyable nor movable
+  //   auto page = Option<Page>::from_fn([&] { return Page(file, offset); });
+  template <typename F>
+    requires details::builds_payload<T, F>
+  static constexpr Option from_fn(F&& f) noexcept(std::is_nothrow_invocable_v<F>) {
+    return Option(details::from_fn_t{}, std::forward<F>(f));
+  }
 
   // from NoneType
-  constexpr Option(details::NoneType) noexcept : std::variant<T, details::NoneType>(details::NoneType{}) {}
+  constexpr Option(details::NoneType) noexcept : _Base() {}
   constexpr Option& operator=(details::NoneType) noexcept {
-    *static_cast<_Base*>(this) = None;
+    this->_m_reset();
     return *this;
   }
 
   // is_some
-  constexpr bool is_some() const noexcept { return this->index() == 0; }
+  constexpr bool is_some() const noexcept { return this->_m_is_some(); }
 
   // is_none
-  constexpr bool is_none() const noexcept { return this->index() == 1; }
+  constexpr bool is_none() const noexcept { return !this->_m_is_some(); }
 
   // is_some_and
   template <typename F>
@@ -188,7 +803,7 @@ class Option : private std::variant<T, details::NoneType> {
     requires std::is_invocable_r_v<bool, F, const T&>
   constexpr bool is_none_or(F&& f) const& noexcept(std::is_nothrow_invocable_v<F, const T&>) {
     if (is_some()) {
-      return F(_m_get_some_value());
+      return f(_m_get_some_value());
     }
     return true;
   }
@@ -196,7 +811,7 @@ class Option : private std::variant<T, details::NoneType> {
     requires std::is_invocable_r_v<bool, F, const T&&>
   constexpr bool is_none_or(F&& f) const&& noexcept(std::is_nothrow_invocable_v<F, T&&>) {
     if (is_some()) {
-      return F(_m_get_some_value());
+      return f(_m_get_some_value());
     }
     return true;
   }
@@ -205,14 +820,22 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, Option&> insert(Args&&... args) & noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
-    this->template emplace<0>(std::forward<Args>(args)...);
+    this->_m_emplace(std::forward<Args>(args)...);
     return *this;
   }
   template <typename U, typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, std::initializer_list<U>&, Args...>, Option&> insert(
       std::initializer_list<U> list,
       Args&&... args) & noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
-    this->template emplace<0>(list, std::forward<Args>(args)...);
+    this->_m_emplace(list, std::forward<Args>(args)...);
+    return *this;
+  }
+
+  // insert_with, like insert with the payload built from f's result in place, see from_fn
+  template <typename F>
+    requires details::builds_payload<T, F>
+  constexpr Option& insert_with(F&& f) & noexcept(std::is_nothrow_invocable_v<F>) {
+    this->_m_emplace_with(std::forward<F>(f));
     return *this;
   }
 
@@ -221,7 +844,7 @@ class Option : private std::variant<T, details::NoneType> {
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, T&> get_or_insert(Args&&... args) & noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
     if (is_none()) {
-      this->template emplace<0>(std::forward<Args>(args)...);
+      this->_m_emplace(std::forward<Args>(args)...);
     }
     return _m_get_some_value();
   }
@@ -230,7 +853,17 @@ class Option : private std::variant<T, details::NoneType> {
       std::initializer_list<U> list,
       Args&&... args) & noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
     if (is_none()) {
-      this->template emplace<0>(list, std::forward<Args>(args)...);
+      this->_m_emplace(list, std::forward<Args>(args)...);
+    }
+    return _m_get_some_value();
+  }
+
+  // get_or_insert_with, f only runs on None, and its result is built in place, see from_fn
+  template <typename F>
+    requires details::builds_payload<T, F>
+  constexpr T& get_or_insert_with(F&& f) & noexcept(std::is_nothrow_invocable_v<F>) {
+    if (is_none()) {
+      this->_m_emplace_with(std::forward<F>(f));
     }
     return _m_get_some_value();
   }
@@ -257,48 +890,57 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, T&> replace(Args&&... args) noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
-    this->template emplace<0>(std::forward<Args>(args)...);
+    this->_m_emplace(std::forward<Args>(args)...);
     return _m_get_some_value();
   }
   template <typename U, typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, std::initializer_list<U>&, Args...>, T&> replace(
       std::initializer_list<U> list,
       Args&&... args) noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
-    this->template emplace<0>(list, std::forward<Args>(args)...);
+    this->_m_emplace(list, std::forward<Args>(args)...);
     return _m_get_some_value();
   }
 
-  // unwrap
+  // unwrap, a None throws option_error at run time and does not compile in constant evaluation,
+  // where the hook and cpptrace are kept out by if consteval
   constexpr T& unwrap() & {
     if (is_some()) {
       return _m_get_some_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      if consteval {
+        details::unwrap_of_none_in_constant_expression();
+      }
+      details::unwrap_failed("unwrap a none option!");
     }
   }
   constexpr const T& unwrap() const& {
     if (is_some()) {
       return _m_get_some_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      if consteval {
+        details::unwrap_of_none_in_constant_expression();
+      }
+      details::unwrap_failed("unwrap a none option!");
     }
   }
   constexpr T&& unwrap() && {
     if (is_some()) {
-      return std::move(_m_get_some_value());
+      return std::forward<T>(this->_m_value());
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      if consteval {
+        details::unwrap_of_none_in_constant_expression();
+      }
+      details::unwrap_failed("unwrap a none option!");
     }
   }
   constexpr const T&& unwrap() const&& {
     if (is_some()) {
-      return std::move(_m_get_some_value());
+      return std::forward<const T>(this->_m_value());
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      if consteval {
+        details::unwrap_of_none_in_constant_expression();
+      }
+      details::unwrap_failed("unwrap a none option!");
     }
   }
 
@@ -308,61 +950,151 @@ class Option : private std::variant<T, details::NoneType> {
     return is_some() ? _m_get_some_value() : const_cast<T&>(_val);
   }
   constexpr T&& unwrap_or(T&& _val) && noexcept {
-    return is_some() ? std::move(_m_get_some_value()) : std::forward<T>(_val);
+    return is_some() ? std::forward<T>(this->_m_value()) : std::forward<T>(_val);
   }
   constexpr const T&& unwrap_or(T&& _val) const&& noexcept {
-    return is_some() ? std::move(_m_get_some_value()) : std::forward<T>(_val);
+    return is_some() ? std::forward<const T>(this->_m_value()) : std::forward<T>(_val);
   }
 
   // unwrap_or_default
   template <typename U = T>
     requires std::is_default_constructible_v<U>
   constexpr U unwrap_or_default() noexcept(std::is_nothrow_default_constructible_v<T>) {
-    return is_some() ? _m_get_some_value() : T();
+    if (is_some()) {
+      return this->_m_value();
+    }
+    return T();
   }
 
   // unwrap_or_else
   template <typename F>
     requires std::is_invocable_r_v<T, F>
   constexpr T unwrap_or_else(F&& f) noexcept(std::is_nothrow_invocable_r_v<T, F>) {
-    return is_some() ? _m_get_some_value() : f();
+    if (is_some()) {
+      return this->_m_value();
+    }
+    return f();
   }
 
   // unwrap_unchecked
   constexpr auto unwrap_unchecked() const { return _m_get_some_value(); }
   constexpr auto unwrap_unchecked() { return _m_get_some_value(); }
 
-  // expected
-  constexpr auto expected(const char* msg) & -> std::add_lvalue_reference_t<T> {
+  // expected, unwrap with the caller's message
+  constexpr T& expected(const char* msg) & {
     if (is_some()) {
-      return _m_get_some_value();
+      return this->_m_value();
     }
-    cpptrace::generate_trace(1).print_with_snippets();
-    throw option_error(msg);
+    if consteval {
+      details::unwrap_of_none_in_constant_expression();
+    }
+    details::unwrap_failed(msg);
+  }
+  constexpr const T& expected(const char* msg) const& {
+    if (is_some()) {
+      return this->_m_value();
+    }
+    if consteval {
+      details::unwrap_of_none_in_constant_expression();
+    }
+    details::unwrap_failed(msg);
+  }
+  constexpr T&& expected(const char* msg) && {
+    if (is_some()) {
+      return std::forward<T>(this->_m_value());
+    }
+    if consteval {
+      details::unwrap_of_none_in_constant_expression();
+    }
+    details::unwrap_failed(msg);
+  }
+  constexpr const T&& expected(const char* msg) const&& {
+    if (is_some()) {
+      return std::forward<const T>(this->_m_value());
+    }
+    if consteval {
+      details::unwrap_of_none_in_constant_expression();
+    }
+    details::unwrap_failed(msg);
   }
 
-  // map
+  // map, Option<U> of f's result U
+  // through an rvalue Option the payload is passed as T&&, so an f taking it by value or by rvalue reuses its buffer
   template <typename F>
     requires std::is_invocable_v<F, const T&>
-  constexpr auto map(F&& f) const& noexcept(std::is_nothrow_invocable_v<F, const T&>) {
-    return is_some() ? f(_m_get_some_value()) : None;
+  constexpr Option<std::remove_cvref_t<std::invoke_result_t<F, const T&>>> map(F&& f) const& noexcept(
+      std::is_nothrow_invocable_v<F, const T&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<F>(f), this->_m_value());
+    }
+    return None;
   }
   template <typename F>
     requires std::is_invocable_v<F, T&&>
-  constexpr auto map(F&& f) && noexcept(std::is_nothrow_invocable_v<F, T&&>) {
-    return is_some() ? f(_m_get_some_value()) : None;
+  constexpr Option<std::remove_cvref_t<std::invoke_result_t<F, T&&>>> map(F&& f) && noexcept(
+      std::is_nothrow_invocable_v<F, T&&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<F>(f), std::forward<T>(this->_m_value()));
+    }
+    return None;
+  }
+
+  // map_in_place, f mutates the payload where it is, for a transform that keeps the type, e.g. an Option<std::string>
+  // taken to upper case reuses its buffer where map would build a new string; returns the Option for chaining
+  template <typename F>
+    requires std::is_invocable_v<F, T&> && std::is_void_v<std::invoke_result_t<F, T&>>
+  constexpr Option& map_in_place(F&& f) & noexcept(std::is_nothrow_invocable_v<F, T&>) {
+    if (is_some()) {
+      std::invoke(std::forward<F>(f), this->_m_value());
+    }
+    return *this;
+  }
+  template <typename F>
+    requires std::is_invocable_v<F, T&> && std::is_void_v<std::invoke_result_t<F, T&>>
+  constexpr Option map_in_place(F&& f) && noexcept(std::is_nothrow_invocable_v<F, T&> &&
+                                                   std::is_nothrow_move_constructible_v<Option>) {
+    if (is_some()) {
+      std::invoke(std::forward<F>(f), this->_m_value());
+    }
+    return std::move(*this);
+  }
+
+  // and_then, f returns an Option itself, which is passed on as is
+  template <typename F>
+    requires details::is_instance_of<std::remove_cvref_t<std::invoke_result_t<F, const T&>>, Option>::value
+  constexpr std::remove_cvref_t<std::invoke_result_t<F, const T&>> and_then(F&& f) const& noexcept(
+      std::is_nothrow_invocable_v<F, const T&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<F>(f), this->_m_value());
+    }
+    return None;
+  }
+  template <typename F>
+    requires details::is_instance_of<std::remove_cvref_t<std::invoke_result_t<F, T&&>>, Option>::value
+  constexpr std::remove_cvref_t<std::invoke_result_t<F, T&&>> and_then(F&& f) && noexcept(
+      std::is_nothrow_invocable_v<F, T&&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<F>(f), std::forward<T>(this->_m_value()));
+    }
+    return None;
   }
 
   // map_or
   template <typename F, typename U = std::invoke_result_t<F, const T&>>
   constexpr std::invoke_result_t<F, const T&> map_or(F&& f, const U& _default) const& noexcept(
       std::is_nothrow_invocable_v<F, const T&>) {
-    return is_some() ? f(_m_get_some_value()) : _default;
+    if (is_some()) {
+      return f(this->_m_value());
+    }
+    return _default;
   }
   template <typename F, typename U = std::invoke_result_t<F, T&&>>
   constexpr std::invoke_result_t<F, const T&> map_or(F&& f,
                                                      U&& _default) && noexcept(std::is_nothrow_invocable_v<F, T&&>) {
-    return is_some() ? f(std::move(_m_get_some_value())) : std::move(_default);
+    if (is_some()) {
+      return f(std::forward<T>(this->_m_value()));
+    }
+    return std::forward<U>(_default);
   }
 
   // map_or_else
@@ -370,23 +1102,90 @@ class Option : private std::variant<T, details::NoneType> {
     requires std::is_same_v<U, std::invoke_result_t<F, const T&>>
   constexpr U map_or_else(D&& _default, F&& f) const& noexcept(std::is_nothrow_invocable_v<F, const T&> &&
                                                                std::is_nothrow_invocable_v<D>) {
-    return is_some() ? f(_m_get_some_value()) : _default();
+    if (is_some()) {
+      return f(this->_m_value());
+    }
+    return _default();
   }
   template <typename D, typename F, typename U = std::invoke_result_t<D>>
     requires std::is_same_v<U, std::invoke_result_t<F, T&&>>
   constexpr U map_or_else(D&& _default,
                           F&& f) && noexcept(std::is_nothrow_invocable_v<F, T&&> && std::is_nothrow_invocable_v<D>) {
-    return is_some() ? f(std::move(_m_get_some_value())) : _default();
+    if (is_some()) {
+      return f(std::forward<T>(this->_m_value()));
+    }
+    return _default();
+  }
+
+  // begin, end, a range of zero or one element
+  constexpr std::add_pointer_t<T> begin() noexcept {
+    return is_some() ? std::addressof(this->_m_value()) : nullptr;
+  }
+  constexpr std::add_pointer_t<const T> begin() const noexcept {
+    return is_some() ? std::addressof(this->_m_value()) : nullptr;
   }
+  constexpr std::add_pointer_t<T> end() noexcept { return begin() + is_some(); }
+  constexpr std::add_pointer_t<const T> end() const noexcept { return begin() + is_some(); }
 
   // as_ref
   constexpr Option<std::reference_wrapper<T>> as_ref() & noexcept {
     using rt_type = Option<std::reference_wrapper<T>>;
     return is_some() ? rt_type{std::ref(_m_get_some_value())} : Option<std::reference_wrapper<T>>{};
   }
-  constexpr Option<std::reference_wrapper<T>> as_ref() const& noexcept {
-    using rt_type = Option<std::reference_wrapper<T>>;
-    return is_some() ? rt_type{std::cref(_m_get_some_value())} : Option<std::reference_wrapper<T>>{};
+  constexpr Option<std::reference_wrapper<const T>> as_ref() const& noexcept {
+    using rt_type = Option<std::reference_wrapper<const T>>;
+    return is_some() ? rt_type{std::cref(_m_get_some_value())} : rt_type{};
+  }
+
+  // project, the payload's member (a member pointer, or any invocable returning a reference into it) without a copy:
+  //   Option<const std::string&> name = record.project(&Record::name);
+  // through an rvalue Option the projection is moved out into an Option<Field>, leaving the rest of the payload
+  template <typename P>
+    requires std::is_invocable_v<P, T&> && std::is_lvalue_reference_v<std::invoke_result_t<P, T&>>
+  constexpr Option<std::invoke_result_t<P, T&>> project(P&& p) & noexcept(std::is_nothrow_invocable_v<P, T&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<P>(p), this->_m_value());
+    }
+    return None;
+  }
+  template <typename P>
+    requires std::is_invocable_v<P, const T&> && std::is_lvalue_reference_v<std::invoke_result_t<P, const T&>>
+  constexpr Option<std::invoke_result_t<P, const T&>> project(P&& p) const& noexcept(
+      std::is_nothrow_invocable_v<P, const T&>) {
+    if (is_some()) {
+      return std::invoke(std::forward<P>(p), this->_m_value());
+    }
+    return None;
+  }
+  // an Option<T&> does not own its payload, so it keeps handing out references
+  template <typename P, typename R = std::invoke_result_t<P, T&&>,
+            typename F = std::conditional_t<std::is_reference_v<T>, R, std::remove_cvref_t<R>>>
+    requires std::is_invocable_v<P, T&&> && std::is_reference_v<R>
+  constexpr Option<F> project(P&& p) && noexcept(std::is_nothrow_invocable_v<P, T&&> &&
+                                                 std::is_nothrow_constructible_v<F, R>) {
+    if (is_some()) {
+      return Option<F>(std::in_place, std::invoke(std::forward<P>(p), std::forward<T>(this->_m_value())));
+    }
+    return None;
+  }
+
+  // flatten, Option<Option<U>> -> Option<U>
+  // with the inner tag reused for the outer None this is a copy of the inner Option plus a select on its tag
+  template <typename U = T>
+    requires details::is_instance_of<U, Option>::value
+  constexpr U flatten() const& noexcept(std::is_nothrow_copy_constructible_v<U>) {
+    if (is_some()) {
+      return this->_m_value();
+    }
+    return None;
+  }
+  template <typename U = T>
+    requires details::is_instance_of<U, Option>::value
+  constexpr U flatten() && noexcept(std::is_nothrow_move_constructible_v<U>) {
+    if (is_some()) {
+      return std::move(this->_m_value());
+    }
+    return None;
   }
 
   // todo list
@@ -396,33 +1195,70 @@ class Option : private std::variant<T, details::NoneType> {
   // or_else
 
  private:
-  // unchecked get value
-  constexpr inline const T& _m_get_some_value() const& { return std::get<T>(*this); }
-  constexpr inline T& _m_get_some_value() & { return std::get<T>(*this); }
-  constexpr inline T&& _m_get_some_value() && { return std::move(std::get<T>(*this)); }
-  constexpr inline const T&& _m_get_some_value() const&& { return std::move(std::get<T>(*this)); }
+  // a spare state of the storage, only built through niche_traits
+  constexpr Option(details::niche_t, std::size_t i) noexcept : _Base(details::niche_t{}, i) {}
+
+  // Some of f's result, see from_fn
+  template <typename F>
+  constexpr Option(details::from_fn_t, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+      : _Base(details::from_fn_t{}, std::forward<F>(f)) {}
+
+  // a None that tells the coroutine promise where the caller's Option lives, see option_coroutine.hpp
+  constexpr Option(details::bind_t, Option*& out) noexcept : _Base() { out = this; }
+
+  // get value, throws std::bad_variant_access on None
+  constexpr inline const T& _m_get_some_value() const& {
+    _m_check_some();
+    return this->_m_value();
+  }
+  constexpr inline T& _m_get_some_value() & {
+    _m_check_some();
+    return this->_m_value();
+  }
+  constexpr inline T&& _m_get_some_value() && {
+    _m_check_some();
+    return std::forward<T>(this->_m_value());
+  }
+  constexpr inline const T&& _m_get_some_value() const&& {
+    _m_check_some();
+    return std::forward<const T>(this->_m_value());
+  }
+  constexpr inline void _m_check_some() const {
+    if (!is_some()) {
+      throw std::bad_variant_access();
+    }
+  }
 };
 
-// from r value
-template <typename T>
-constexpr Option<T> Some(T&& _val) noexcept {
-  return Option<T>(_val);
+// an Option lends its unused discriminant values (or what is left of its payload's niche) to an enclosing Option,
+// so Option<Option<T>> is no bigger than Option<T>
+template <typename U, typename R>
+struct niche_traits<Option<U, R>> {
+  static constexpr std::size_t count = details::option_storage_t<U, R>::_s_niche_count;
+  static constexpr Option<U, R> make(std::size_t i) noexcept { return Option<U, R>(details::niche_t{}, i); }
+  static constexpr std::size_t index(const Option<U, R>& o) noexcept { return o._m_niche_index(); }
+};
+
+// from r value, an lvalue is copied, Option<T&> is only made explicitly
+NAVP_EXPORT template <typename T>
+constexpr Option<std::remove_cvref_t<T>> Some(T&& _val) noexcept {
+  return Option<std::remove_cvref_t<T>>(std::forward<T>(_val));
 }
 
 // from l value
-template <typename T>
+NAVP_EXPORT template <typename T>
 constexpr Option<T> Some(const T& _val) noexcept {
   return Option<T>(std::move(_val));
 }
 
 // construct in_place
-template <typename T, typename... Args>
+NAVP_EXPORT template <typename T, typename... Args>
   requires std::is_constructible_v<T, Args...>
 constexpr Option<T> Some(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
   return Option<T>(std::forward<Args>(args)...);
 }
 
-template <typename T, typename U, typename... Args>
+NAVP_EXPORT template <typename T, typename U, typename... Args>
   requires std::is_constructible_v<T, std::initializer_list<U>&, Args...>
 constexpr Option<T> Some(std::initializer_list<U> list, Args&&... args) noexcept(
     std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
@@ -430,3 +1266,5 @@ constexpr Option<T> Some(std::initializer_list<U> list, Args&&... args) noexcept
 }
 
 }  // namespace navp
+
+#endif  // !(NAVP_OPTION_MODULE && NAVP_OPTION_UNWRAP_DEFINITION)
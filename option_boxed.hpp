@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "option.hpp"
+
+// the storage of Option<T, Boxed>, kept out of option.hpp so the pool's thread-local free lists and <mutex>
+// only reach the units that box their payloads
+namespace navp::details {
+
+// box_pool, the blocks of every Boxed payload of one size and alignment
+// each thread pops and pushes a short free list of its own without a lock, and exchanges blocks with a shared list
+// in batches, so a block freed on another thread is reused there; the chunks the blocks are cut from are kept
+// for reuse and never given back to the system
+template <std::size_t Size, std::size_t Align>
+class box_pool {
+  struct _Block {
+    _Block* next;
+  };
+
+ public:
+  static constexpr std::size_t block_align = std::max(Align, alignof(_Block));
+  static constexpr std::size_t block_size =
+      (std::max(Size, sizeof(_Block)) + block_align - 1) / block_align * block_align;
+
+  static void* allocate() {
+    auto& cache = _s_cache;
+    if (cache.head == nullptr) [[unlikely]] {
+      _s_refill(cache);
+    }
+    auto* block = cache.head;
+    cache.head = block->next;
+    --cache.count;
+    return block;
+  }
+
+  static void deallocate(void* p) noexcept {
+    auto& cache = _s_cache;
+    auto* block = static_cast<_Block*>(p);
+    if (cache.exited) [[unlikely]] {
+      std::lock_guard guard(_s_shared.lock);
+      block->next = _s_shared.head;
+      _s_shared.head = block;
+      ++_s_shared.count;
+      return;
+    }
+    if (cache.count == 0) {
+      _s_arm();
+    }
+    block->next = cache.head;
+    cache.head = block;
+    if (++cache.count == 2 * _s_batch) [[unlikely]] {
+      _s_drain(cache, _s_batch);
+    }
+  }
+
+  // blocks on the shared list, for tests and diagnostics
+  static std::size_t shared_blocks() noexcept {
+    std::lock_guard guard(_s_shared.lock);
+    return _s_shared.count;
+  }
+
+ private:
+  // about 16 KiB of blocks move at a time
+  static constexpr std::size_t _s_batch = std::clamp<std::size_t>(16384 / block_size, 4, 256);
+  // the chunk list link, padded so the blocks after it stay aligned
+  static constexpr std::size_t _s_header = (sizeof(void*) + block_align - 1) / block_align * block_align;
+
+  struct _Cache {
+    _Block* head;
+    std::size_t count;
+    bool exited;
+  };
+
+  struct _Shared {
+    std::mutex lock;
+    _Block* head = nullptr;
+    std::size_t count = 0;
+    void* chunks = nullptr;
+  };
+
+  // hands the thread's blocks back when it exits, later frees on the thread go straight to the shared list
+  struct _Flush {
+    ~_Flush() {
+      auto& cache = _s_cache;
+      if (cache.count != 0) {
+        _s_drain(cache, cache.count);
+      }
+      cache.exited = true;
+    }
+  };
+
+  // the first touch registers _s_flush's destructor for this thread, _s_cache itself stays trivial and cheap to reach
+  static void _s_arm() noexcept {
+    [[maybe_unused]] auto* volatile flush = &_s_flush;
+  }
+
+  static void _s_refill(_Cache& cache) {
+    if (!cache.exited) {
+      _s_arm();
+    }
+    std::lock_guard guard(_s_shared.lock);
+    if (_s_shared.head == nullptr) {
+      _s_carve();
+    }
+    // after the thread exited, a block at a time
+    auto want = cache.exited ? std::size_t(1) : _s_batch;
+    while (cache.count < want && _s_shared.head != nullptr) {
+      auto* block = _s_shared.head;
+      _s_shared.head = block->next;
+      --_s_shared.count;
+      block->next = cache.head;
+      cache.head = block;
+      ++cache.count;
+    }
+  }
+
+  static void _s_drain(_Cache& cache, std::size_t n) noexcept {
+    auto* first = cache.head;
+    auto* last = first;
+    for (std::size_t i = 1; i < n; ++i) {
+      last = last->next;
+    }
+    cache.head = last->next;
+    cache.count -= n;
+    std::lock_guard guard(_s_shared.lock);
+    last->next = _s_shared.head;
+    _s_shared.head = first;
+    _s_shared.count += n;
+  }
+
+  // called with the shared lock held
+  static void _s_carve() {
+    auto* chunk = static_cast<unsigned char*>(
+        ::operator new(_s_header + _s_batch * block_size, std::align_val_t(block_align)));
+    *reinterpret_cast<void**>(chunk) = _s_shared.chunks;
+    _s_shared.chunks = chunk;
+    for (std::size_t i = _s_batch; i-- > 0;) {
+      auto* block = reinterpret_cast<_Block*>(chunk + _s_header + i * block_size);
+      block->next = _s_shared.head;
+      _s_shared.head = block;
+    }
+    _s_shared.count += _s_batch;
+  }
+
+  static inline thread_local constinit _Cache _s_cache{};
+  static inline thread_local _Flush _s_flush;
+  static inline constinit _Shared _s_shared{};
+};
+
+template <typename T>
+struct option_storage<T, Boxed> {
+  static constexpr std::size_t _s_niche_count = 0;
+
+  constexpr option_storage() noexcept : _m_ptr(nullptr) {}
+  template <typename... Args>
+  constexpr explicit option_storage(std::in_place_t, Args&&... args) : _m_ptr(_s_make(std::forward<Args>(args)...)) {}
+  template <typename F>
+  constexpr option_storage(from_fn_t, F&& f) : _m_ptr(_s_make_with(std::forward<F>(f))) {}
+
+  constexpr option_storage(const option_storage& other)
+    requires std::is_copy_constructible_v<T>
+      : _m_ptr(other._m_ptr != nullptr ? _s_make(*other._m_ptr) : nullptr) {}
+  constexpr option_storage(option_storage&& other) noexcept : _m_ptr(std::exchange(other._m_ptr, nullptr)) {}
+
+  constexpr option_storage& operator=(const option_storage& other)
+    requires(std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>)
+  {
+    if (other._m_ptr == nullptr) {
+      _m_reset();
+    } else if (_m_ptr != nullptr) {
+      *_m_ptr = *other._m_ptr;
+    } else {
+      _m_ptr = _s_make(*other._m_ptr);
+    }
+    return *this;
+  }
+  constexpr option_storage& operator=(option_storage&& other) noexcept {
+    if (this != &other) {
+      _m_reset();
+      _m_ptr = std::exchange(other._m_ptr, nullptr);
+    }
+    return *this;
+  }
+
+  constexpr ~option_storage() { _m_reset(); }
+
+  constexpr bool _m_is_some() const noexcept { return _m_ptr != nullptr; }
+
+  constexpr const T& _m_value() const noexcept { return *_m_ptr; }
+  constexpr T& _m_value() noexcept { return *_m_ptr; }
+
+  // the old block goes back to the pool first, which hands the same one out again
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) {
+    _m_reset();
+    _m_ptr = _s_make(std::forward<Args>(args)...);
+  }
+
+  template <typename F>
+  constexpr void _m_emplace_with(F&& f) {
+    _m_reset();
+    _m_ptr = _s_make_with(std::forward<F>(f));
+  }
+
+  constexpr void _m_reset() noexcept {
+    if (_m_ptr != nullptr) {
+      std::destroy_at(_m_ptr);
+      _s_deallocate(std::exchange(_m_ptr, nullptr));
+    }
+  }
+
+  using _Pool = box_pool<sizeof(T), alignof(T)>;
+
+  // constant evaluation cannot reach the pool, std::allocator is its transient heap
+  static constexpr T* _s_allocate() {
+    if consteval {
+      return std::allocator<T>().allocate(1);
+    }
+    return static_cast<T*>(_Pool::allocate());
+  }
+  static constexpr void _s_deallocate(T* block) noexcept {
+    if consteval {
+      std::allocator<T>().deallocate(block, 1);
+    } else {
+      _Pool::deallocate(block);
+    }
+  }
+
+  template <typename... Args>
+  static constexpr T* _s_make(Args&&... args) {
+    T* block = _s_allocate();
+    try {
+      std::construct_at(block, std::forward<Args>(args)...);
+    } catch (...) {
+      _s_deallocate(block);
+      throw;
+    }
+    return block;
+  }
+
+  // placement new keeps f's prvalue from moving, as in the Tagged storage
+  template <typename F>
+  static constexpr T* _s_make_with(F&& f) {
+    T* block = _s_allocate();
+    try {
+      if constexpr (std::is_move_constructible_v<T>) {
+        if consteval {
+          std::construct_at(block, std::invoke(std::forward<F>(f)));
+          return block;
+        }
+      }
+      ::new (static_cast<void*>(block)) T(std::invoke(std::forward<F>(f)));
+    } catch (...) {
+      _s_deallocate(block);
+      throw;
+    }
+    return block;
+  }
+
+  T* _m_ptr;
+};
+
+}  // namespace navp::details
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrency.hpp"
+#include "option.hpp"
+
+namespace navp {
+
+// sharded concurrent memoization cache for Option-returning lookups
+// a None answer is cached just like a Some one (negative caching), eviction is CLOCK so hits only take a shared lock
+// answers are Option<V> as given, a pointer-like V keeps its null niche, so a null answer is the negative one
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class OptionCache {
+ public:
+  explicit OptionCache(std::size_t capacity, std::size_t shards = 16) : _m_hash() {
+    shards = shards == 0 ? 1 : shards;
+    auto per_shard = (capacity + shards - 1) / shards;
+    _m_shards.reserve(shards);
+    for (std::size_t i = 0; i < shards; ++i) {
+      _m_shards.push_back(std::make_unique<_Shard>(per_shard == 0 ? 1 : per_shard));
+    }
+  }
+
+  OptionCache(const OptionCache&) = delete;
+  OptionCache& operator=(const OptionCache&) = delete;
+
+  // get, outer None means "not cached", Some(None) is a cached negative answer
+  Option<Option<V>> get(const K& key) const {
+    auto& shard = _m_shard(key);
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      return None;
+    }
+    auto& slot = shard.slots[it->second];
+    slot.referenced.store(true, std::memory_order_relaxed);
+    return Option<Option<V>>(std::in_place, slot.value);
+  }
+
+  // put, overwrites a cached answer
+  void put(const K& key, Option<V> value) {
+    auto& shard = _m_shard(key);
+    std::unique_lock lock(shard.mutex);
+    shard.insert(key, std::move(value));
+  }
+
+  // get_or_compute, concurrent misses on one key run f once, the others wait for its answer
+  // an exception thrown by f reaches every waiter and nothing is cached
+  template <typename F>
+    requires std::is_invocable_r_v<Option<V>, F, const K&>
+  Option<V> get_or_compute(const K& key, F&& f) {
+    if (auto cached = get(key)) {
+      return std::move(cached).unwrap();
+    }
+    auto& shard = _m_shard(key);
+    std::promise<Option<V>> promise;
+    {
+      std::unique_lock lock(shard.mutex);
+      if (auto it = shard.index.find(key); it != shard.index.end()) {
+        return shard.slots[it->second].value;
+      }
+      if (auto it = shard.inflight.find(key); it != shard.inflight.end()) {
+        auto future = it->second;
+        lock.unlock();
+        return future.get();
+      }
+      shard.inflight.emplace(key, promise.get_future().share());
+    }
+    try {
+      Option<V> value = std::invoke(std::forward<F>(f), key);
+      {
+        std::unique_lock lock(shard.mutex);
+        shard.insert(key, value);
+        shard.inflight.erase(key);
+      }
+      promise.set_value(value);
+      return value;
+    } catch (...) {
+      {
+        std::unique_lock lock(shard.mutex);
+        shard.inflight.erase(key);
+      }
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+  // erase, returns whether the key was cached
+  bool erase(const K& key) {
+    auto& shard = _m_shard(key);
+    std::unique_lock lock(shard.mutex);
+    return shard.erase(key);
+  }
+
+  void clear() {
+    for (auto& shard : _m_shards) {
+      std::unique_lock lock(shard->mutex);
+      shard->clear();
+    }
+  }
+
+  std::size_t size() const {
+    std::size_t count = 0;
+    for (auto& shard : _m_shards) {
+      std::shared_lock lock(shard->mutex);
+      count += shard->index.size();
+    }
+    return count;
+  }
+
+ private:
+  struct _Slot {
+    const K* key = nullptr;  // points into the shard index, nullptr when the slot is free
+    Option<V> value;
+    std::atomic<bool> referenced{false};
+  };
+
+  struct alignas(details::cache_line_size) _Shard {
+    explicit _Shard(std::size_t capacity) : slots(std::make_unique<_Slot[]>(capacity)), capacity(capacity) {}
+
+    void insert(const K& key, Option<V> value) {
+      if (auto it = index.find(key); it != index.end()) {
+        auto& slot = slots[it->second];
+        slot.value = std::move(value);
+        slot.referenced.store(true, std::memory_order_relaxed);
+        return;
+      }
+      auto victim = sweep();
+      auto& slot = slots[victim];
+      // the new entry goes in before the evicted one comes out, a throwing emplace leaves the shard as it was
+      auto [it, _] = index.emplace(key, victim);
+      if (slot.key != nullptr) {
+        index.erase(*slot.key);
+      }
+      slot.key = &it->first;
+      slot.value = std::move(value);
+      slot.referenced.store(false, std::memory_order_relaxed);
+    }
+
+    bool erase(const K& key) {
+      auto it = index.find(key);
+      if (it == index.end()) {
+        return false;
+      }
+      auto& slot = slots[it->second];
+      slot.key = nullptr;
+      slot.value = None;
+      index.erase(it);
+      return true;
+    }
+
+    void clear() {
+      index.clear();
+      for (std::size_t i = 0; i < capacity; ++i) {
+        slots[i].key = nullptr;
+        slots[i].value = None;
+      }
+    }
+
+    // clock hand, gives recently referenced slots a second chance
+    std::size_t sweep() noexcept {
+      for (;;) {
+        auto i = hand;
+        hand = hand + 1 == capacity ? 0 : hand + 1;
+        if (slots[i].key == nullptr || !slots[i].referenced.exchange(false, std::memory_order_relaxed)) {
+          return i;
+        }
+      }
+    }
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<K, std::size_t, Hash, KeyEqual> index;
+    std::unordered_map<K, std::shared_future<Option<V>>, Hash, KeyEqual> inflight;
+    std::unique_ptr<_Slot[]> slots;
+    std::size_t capacity;
+    std::size_t hand = 0;
+  };
+
+  _Shard& _m_shard(const K& key) const noexcept {
+    // fibonacci mix, so the shard does not correlate with the bucket inside the shard
+    auto h = static_cast<std::uint64_t>(_m_hash(key)) * 0x9e3779b97f4a7c15ull;
+    return *_m_shards[(h >> 32) % _m_shards.size()];
+  }
+
+  Hash _m_hash;
+  std::vector<std::unique_ptr<_Shard>> _m_shards;
+};
+
+}  // namespace navp
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+
+namespace navp {
+
+// OptionColumn, a sequence of Option<T> whose discriminants live in a side bitmap
+// payloads stay densely packed, so an over-aligned T costs sizeof(T) plus one bit per element
+template <typename T>
+class OptionColumn {
+ public:
+  OptionColumn() noexcept = default;
+
+  OptionColumn(const OptionColumn& other) : _m_bits(other._m_bits) {
+    _PrefixGuard guard{*this, _s_allocate(other._m_size)};
+    for (; guard.count < other._m_size; ++guard.count) {
+      if (is_some(guard.count)) {
+        std::construct_at(guard.data + guard.count, other._m_data[guard.count]);
+      }
+    }
+    _m_data = guard.release();
+    _m_size = _m_capacity = other._m_size;
+  }
+
+  // from raw values and their presence bitmap, bit i % 64 of some_bits[i / 64] set when values[i] is Some
+  // the other values are never read
+  OptionColumn(std::span<const T> values, std::vector<std::uint64_t> some_bits) : _m_bits(std::move(some_bits)) {
+    _m_bits.resize((values.size() + 63) / 64);
+    if (values.size() % 64 != 0) {
+      _m_bits.back() &= (std::uint64_t{1} << (values.size() % 64)) - 1;
+    }
+    _PrefixGuard guard{*this, _s_allocate(values.size())};
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (!values.empty()) {
+        std::memcpy(static_cast<void*>(guard.data), values.data(), values.size_bytes());
+      }
+    } else {
+      for (; guard.count < values.size(); ++guard.count) {
+        if (is_some(guard.count)) {
+          std::construct_at(guard.data + guard.count, values[guard.count]);
+        }
+      }
+    }
+    _m_data = guard.release();
+    _m_size = _m_capacity = values.size();
+  }
+
+  OptionColumn(OptionColumn&& other) noexcept
+      : _m_data(std::exchange(other._m_data, nullptr)),
+        _m_bits(std::move(other._m_bits)),
+        _m_size(std::exchange(other._m_size, 0)),
+        _m_capacity(std::exchange(other._m_capacity, 0)) {}
+
+  OptionColumn& operator=(OptionColumn other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~OptionColumn() {
+    clear();
+    _s_deallocate(_m_data);
+  }
+
+  void swap(OptionColumn& other) noexcept {
+    std::swap(_m_data, other._m_data);
+    std::swap(_m_bits, other._m_bits);
+    std::swap(_m_size, other._m_size);
+    std::swap(_m_capacity, other._m_capacity);
+  }
+
+  std::size_t size() const noexcept { return _m_size; }
+  std::size_t capacity() const noexcept { return _m_capacity; }
+  bool empty() const noexcept { return _m_size == 0; }
+
+  void reserve(std::size_t n) {
+    if (n <= _m_capacity) {
+      return;
+    }
+    _PrefixGuard guard{*this, _s_allocate(n)};
+    _m_relocate(guard, n);
+  }
+
+  void clear() noexcept {
+    for (std::size_t i = 0; i < _m_size; ++i) {
+      if (is_some(i)) {
+        std::destroy_at(_m_data + i);
+      }
+    }
+    _m_bits.clear();
+    _m_size = 0;
+  }
+
+  // is_some, is_none
+  bool is_some(std::size_t i) const noexcept { return (_m_bits[i / 64] >> (i % 64)) & 1u; }
+  bool is_none(std::size_t i) const noexcept { return !is_some(i); }
+
+  // element access, borrowed as Option<T&> like the elements of SentinelView
+  Option<T&> operator[](std::size_t i) noexcept { return is_some(i) ? Option<T&>(_m_data[i]) : None; }
+  Option<const T&> operator[](std::size_t i) const noexcept {
+    return is_some(i) ? Option<const T&>(_m_data[i]) : None;
+  }
+
+  // emplace_back, push_back, push_none
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    _m_grow_bits();
+    if (_m_size == _m_capacity) {
+      // built in the new buffer before the old elements move, args may refer to one of them (push_back(*col[0]))
+      auto n = _m_next_capacity();
+      _PrefixGuard guard{*this, _s_allocate(n)};
+      guard.last = std::construct_at(guard.data + _m_size, std::forward<Args>(args)...);
+      _m_relocate(guard, n);
+    } else {
+      std::construct_at(_m_data + _m_size, std::forward<Args>(args)...);
+    }
+    _m_bits[_m_size / 64] |= std::uint64_t{1} << (_m_size % 64);
+    return _m_data[_m_size++];
+  }
+  void push_back(const Option<T>& val) {
+    val.is_some() ? void(emplace_back(val.unwrap())) : push_none();
+  }
+  void push_back(Option<T>&& val) { val.is_some() ? void(emplace_back(std::move(val).unwrap())) : push_none(); }
+  void push_none() {
+    _m_grow_bits();
+    if (_m_size == _m_capacity) {
+      reserve(_m_next_capacity());
+    }
+    ++_m_size;
+  }
+
+  // replace, reset
+  template <typename... Args>
+  T& replace(std::size_t i, Args&&... args) {
+    reset(i);
+    std::construct_at(_m_data + i, std::forward<Args>(args)...);
+    _m_bits[i / 64] |= std::uint64_t{1} << (i % 64);
+    return _m_data[i];
+  }
+  void reset(std::size_t i) noexcept {
+    if (is_some(i)) {
+      std::destroy_at(_m_data + i);
+      _m_bits[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+    }
+  }
+
+  // count_some
+  std::size_t count_some() const noexcept {
+    std::size_t count = 0;
+    for (auto word : _m_bits) {
+      count += static_cast<std::size_t>(std::popcount(word));
+    }
+    return count;
+  }
+
+ private:
+  // _PrefixGuard, unwinds a buffer being filled: destroys the Somes below count, and last when set, then frees it,
+  // unless released
+  struct _PrefixGuard {
+    const OptionColumn& column;
+    T* data;
+    std::size_t count = 0;
+    T* last = nullptr;
+
+    ~_PrefixGuard() {
+      if (data != nullptr) {
+        for (std::size_t i = 0; i < count; ++i) {
+          if (column.is_some(i)) {
+            std::destroy_at(data + i);
+          }
+        }
+        if (last != nullptr) {
+          std::destroy_at(last);
+        }
+        _s_deallocate(data);
+      }
+    }
+
+    T* release() noexcept { return std::exchange(data, nullptr); }
+  };
+
+  static T* _s_allocate(std::size_t n) {
+    return n == 0 ? nullptr : static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+  static void _s_deallocate(T* data) noexcept {
+    if (data != nullptr) {
+      ::operator delete(data, std::align_val_t{alignof(T)});
+    }
+  }
+
+  // _m_relocate, moves the payloads into the guarded buffer of n elements and adopts it
+  // the old payloads are only destroyed once every one has a new home, a throwing copy leaves them untouched
+  void _m_relocate(_PrefixGuard& guard, std::size_t n) {
+    for (; guard.count < _m_size; ++guard.count) {
+      if (is_some(guard.count)) {
+        std::construct_at(guard.data + guard.count, std::move_if_noexcept(_m_data[guard.count]));
+      }
+    }
+    for (std::size_t i = 0; i < _m_size; ++i) {
+      if (is_some(i)) {
+        std::destroy_at(_m_data + i);
+      }
+    }
+    _s_deallocate(std::exchange(_m_data, guard.release()));
+    _m_capacity = n;
+  }
+
+  std::size_t _m_next_capacity() const noexcept { return _m_capacity == 0 ? 8 : _m_capacity * 2; }
+
+  // a word for the element about to be appended, a spare zero word left by a throw is harmless
+  void _m_grow_bits() {
+    if (_m_bits.size() * 64 == _m_size) {
+      _m_bits.push_back(0);
+    }
+  }
+
+  T* _m_data = nullptr;
+  std::vector<std::uint64_t> _m_bits;
+  std::size_t _m_size = 0;
+  std::size_t _m_capacity = 0;
+};
+
+}  // namespace navp
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+// Option<T> as a coroutine return type, `co_await opt` is the value of a Some or returns None from the whole function:
+//   Option<int> total(const Db& db, Key k) {
+//     auto& row = co_await db.find(k);
+//     co_return co_await row.get("a") + co_await row.get("b");
+//   }
+// the body runs to completion inside the call and the frame never escapes it, which is what lets the compiler
+// elide the frame allocation; when it does not, the frame comes from the allocator passed as
+// (std::allocator_arg, alloc, ...) leading the parameters, or from the global heap
+// gcc 12 mis-destroys a frame whose None was awaited inside an if/while condition, it goes on to resume it,
+// so keep co_await out of conditions there: `auto v = co_await o; if (v < 0) ...`
+namespace navp {
+
+namespace details {
+
+// frame allocation, a deallocation thunk and the allocator are stored after the frame,
+// so the sized operator delete finds its way back to the allocator that made the frame
+struct option_frame {
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) _Block {
+    unsigned char bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+  };
+  using _Dealloc = void (*)(void* frame, std::size_t size) noexcept;
+
+  static constexpr std::size_t _s_round(std::size_t n, std::size_t align) noexcept {
+    return (n + align - 1) / align * align;
+  }
+  static constexpr std::size_t _s_thunk_offset(std::size_t size) noexcept { return _s_round(size, alignof(_Dealloc)); }
+  template <typename Alloc>
+  static constexpr std::size_t _s_alloc_offset(std::size_t size) noexcept {
+    return _s_round(_s_thunk_offset(size) + sizeof(_Dealloc), alignof(Alloc));
+  }
+  template <typename Alloc>
+  static constexpr std::size_t _s_blocks(std::size_t size) noexcept {
+    return (_s_alloc_offset<Alloc>(size) + sizeof(Alloc) + sizeof(_Block) - 1) / sizeof(_Block);
+  }
+
+  template <typename Alloc>
+  static void* allocate(std::size_t size, const Alloc& alloc) {
+    using _Rebound = typename std::allocator_traits<Alloc>::template rebind_alloc<_Block>;
+    static_assert(alignof(_Rebound) <= alignof(_Block), "over-aligned allocators are not supported");
+    _Rebound blocks(alloc);
+    auto* frame = reinterpret_cast<unsigned char*>(std::allocator_traits<_Rebound>::allocate(blocks, _s_blocks<_Rebound>(size)));
+    ::new (static_cast<void*>(frame + _s_thunk_offset(size))) _Dealloc(&_s_deallocate<_Rebound>);
+    ::new (static_cast<void*>(frame + _s_alloc_offset<_Rebound>(size))) _Rebound(std::move(blocks));
+    return frame;
+  }
+
+  static void deallocate(void* frame, std::size_t size) noexcept {
+    auto* thunk = std::launder(reinterpret_cast<_Dealloc*>(static_cast<unsigned char*>(frame) + _s_thunk_offset(size)));
+    (*thunk)(frame, size);
+  }
+
+  template <typename Alloc>
+  static void _s_deallocate(void* frame, std::size_t size) noexcept {
+    auto* stored = std::launder(reinterpret_cast<Alloc*>(static_cast<unsigned char*>(frame) + _s_alloc_offset<Alloc>(size)));
+    Alloc blocks(std::move(*stored));
+    std::destroy_at(stored);
+    std::allocator_traits<Alloc>::deallocate(blocks, static_cast<_Block*>(frame), _s_blocks<Alloc>(size));
+  }
+};
+
+// awaiting an Option, a None destroys the frame, which leaves the caller's Option at None
+// O is the reference type the Option was awaited as, a temporary hands its value out by value
+template <typename O>
+struct option_awaiter {
+  using _Value = decltype(std::declval<O>().unwrap());
+  using _Result = std::conditional_t<std::is_lvalue_reference_v<O>, _Value, std::remove_cvref_t<_Value>>;
+
+  constexpr bool await_ready() const noexcept { return _m_option.is_some(); }
+  void await_suspend(std::coroutine_handle<> frame) const noexcept { frame.destroy(); }
+  constexpr _Result await_resume() { return std::forward<O>(_m_option).unwrap(); }
+
+  O _m_option;
+};
+
+template <typename T, typename Repr>
+struct option_promise {
+  using _Option = Option<T, Repr>;
+
+  // what get_return_object hands back, converted into the caller's Option either before the body runs
+  // (then the body writes straight into the caller's Option) or after the frame is gone (then it moves out
+  // what the body wrote here), compilers are free to pick either
+  class _Return {
+   public:
+    explicit _Return(option_promise& promise) noexcept : _m_promise(&promise) {
+      promise._m_out = &_m_storage;
+      promise._m_return = this;
+    }
+    _Return(const _Return&) = delete;
+    _Return& operator=(const _Return&) = delete;
+
+    // an exception leaving the body may destroy us before the frame
+    ~_Return() {
+      if (_m_promise != nullptr) {
+        _m_promise->_m_return = nullptr;
+      }
+    }
+
+    operator _Option() noexcept(std::is_nothrow_move_constructible_v<_Option>) {
+      if (_m_promise != nullptr) {
+        _m_promise->_m_return = nullptr;
+        return _s_bind(*_m_promise);
+      }
+      return std::move(_m_storage);
+    }
+
+   private:
+    friend struct option_promise;
+
+    option_promise* _m_promise;
+    _Option _m_storage;
+  };
+
+  option_promise() noexcept = default;
+  option_promise(const option_promise&) = delete;
+  option_promise& operator=(const option_promise&) = delete;
+
+  ~option_promise() {
+    if (_m_return != nullptr) {
+      _m_return->_m_promise = nullptr;
+    }
+  }
+
+  static void* operator new(std::size_t size) { return option_frame::allocate(size, std::allocator<std::byte>()); }
+  template <typename Alloc, typename... Args>
+  static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+    return option_frame::allocate(size, alloc);
+  }
+  // member function coroutines see the object first
+  template <typename This, typename Alloc, typename... Args>
+  static void* operator new(std::size_t size, const This&, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+    return option_frame::allocate(size, alloc);
+  }
+  static void operator delete(void* frame, std::size_t size) noexcept { option_frame::deallocate(frame, size); }
+
+  _Return get_return_object() noexcept { return _Return(*this); }
+  std::suspend_never initial_suspend() const noexcept { return {}; }
+  std::suspend_never final_suspend() const noexcept { return {}; }
+  void unhandled_exception() const { throw; }
+
+  // co_return a value, an Option or None
+  template <typename U = T>
+    requires std::is_assignable_v<_Option&, U>
+  void return_value(U&& val) {
+    *_m_out = std::forward<U>(val);
+  }
+  template <typename U = T>
+    requires(!std::is_assignable_v<_Option&, U> && std::is_constructible_v<T, U>)
+  void return_value(U&& val) {
+    _m_out->replace(std::forward<U>(val));
+  }
+
+  // co_await works on Options only, anything else has no meaning inside an Option coroutine
+  template <typename U, typename R>
+  option_awaiter<Option<U, R>&> await_transform(Option<U, R>& opt) noexcept {
+    return {opt};
+  }
+  template <typename U, typename R>
+  option_awaiter<const Option<U, R>&> await_transform(const Option<U, R>& opt) noexcept {
+    return {opt};
+  }
+  template <typename U, typename R>
+  option_awaiter<Option<U, R>&&> await_transform(Option<U, R>&& opt) noexcept {
+    return {std::move(opt)};
+  }
+
+ private:
+  static _Option _s_bind(option_promise& promise) noexcept { return _Option(bind_t{}, promise._m_out); }
+
+  _Option* _m_out = nullptr;
+  _Return* _m_return = nullptr;
+};
+
+}  // namespace details
+
+}  // namespace navp
+
+template <typename T, typename Repr, typename... Args>
+struct std::coroutine_traits<navp::Option<T, Repr>, Args...> {
+  using promise_type = navp::details::option_promise<T, Repr>;
+};
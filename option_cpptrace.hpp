@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cpptrace/cpptrace.hpp>
+
+#include "option.hpp"
+
+namespace navp {
+
+// cpptrace_unwrap_hook, prints the stack trace of a failed unwrap with source snippets,
+// for a program built without NAVP_OPTION_CPPTRACE that still wants traces: set_unwrap_hook(cpptrace_unwrap_hook)
+inline void cpptrace_unwrap_hook(const char*) {
+  // skips this hook, unwrap_failed and the unwrap itself
+  cpptrace::generate_trace(3).print_with_snippets();
+}
+
+}  // namespace navp
@@ -0,0 +1,3 @@
+// the navp_option library: the unwrap failure path, so cpptrace is only included here when it is enabled
+#define NAVP_OPTION_UNWRAP_DEFINITION
+#include "option.hpp"
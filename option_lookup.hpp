@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+namespace navp {
+
+namespace details {
+
+// a container whose find takes K, through its transparent comparator or hash when it has one
+template <typename M, typename K>
+concept findable = requires(M& m, const K& key) {
+  { m.find(key) } -> std::same_as<decltype(m.end())>;
+};
+
+// an element reached through reference R can be lent out as an Option<R>
+template <typename R>
+concept lendable = std::is_lvalue_reference_v<R>;
+
+}  // namespace details
+
+// get, the mapped value of key (the element itself for a set), or None, with a single find:
+//   if (auto port = navp::get(ports, "https")) use(port.unwrap());
+// instead of contains and at, which probe twice; a const container gives Option<const V&>
+// a heterogeneous key (e.g. string_view into std::map<std::string, V, std::less<>>) is passed through as is
+template <typename M, typename K>
+  requires details::findable<M, K>
+constexpr auto get(M& map, const K& key) {
+  if constexpr (requires { typename M::mapped_type; }) {
+    using R = decltype((map.find(key)->second));
+    auto it = map.find(key);
+    return it == map.end() ? Option<R>(None) : Option<R>(it->second);
+  } else {
+    using R = decltype(*map.find(key));
+    auto it = map.find(key);
+    return it == map.end() ? Option<R>(None) : Option<R>(*it);
+  }
+}
+
+// get, the element at index i of a random access container, or None past the end
+template <typename C>
+  requires(std::ranges::random_access_range<C> && std::ranges::sized_range<C> &&
+           details::lendable<std::ranges::range_reference_t<C>> && !details::findable<C, std::size_t>)
+constexpr Option<std::ranges::range_reference_t<C>> get(C& seq, std::size_t i) {
+  if (i < static_cast<std::size_t>(std::ranges::size(seq))) {
+    return std::ranges::begin(seq)[static_cast<std::ranges::range_difference_t<C>>(i)];
+  }
+  return None;
+}
+
+// front, back, the first and last element, or None when c is empty
+template <typename C>
+  requires requires(C& c) {
+    c.empty();
+    c.front();
+  } && details::lendable<decltype(std::declval<C&>().front())>
+constexpr Option<decltype(std::declval<C&>().front())> front(C& c) {
+  if (c.empty()) {
+    return None;
+  }
+  return c.front();
+}
+
+template <typename C>
+  requires requires(C& c) {
+    c.empty();
+    c.back();
+  } && details::lendable<decltype(std::declval<C&>().back())>
+constexpr Option<decltype(std::declval<C&>().back())> back(C& c) {
+  if (c.empty()) {
+    return None;
+  }
+  return c.back();
+}
+
+// try_pop, takes the next element out of a std::queue, std::stack or std::priority_queue, or None when empty
+// the element is moved out, except from a priority_queue, whose top is const and is copied
+template <typename Q>
+  requires requires(Q& q) {
+    q.empty();
+    q.pop();
+    typename Q::value_type;
+  }
+constexpr Option<typename Q::value_type> try_pop(Q& q) {
+  if (q.empty()) {
+    return None;
+  }
+  auto take = [&]() -> decltype(auto) {
+    if constexpr (requires { q.front(); }) {
+      return std::move(q.front());
+    } else {
+      return std::move(q.top());
+    }
+  };
+  Option<typename Q::value_type> out(std::in_place, take());
+  q.pop();
+  return out;
+}
+
+}  // namespace navp
@@ -0,0 +1,15 @@
+// the part of navp.option that may need cpptrace, compiled once instead of in every importer:
+// the unwrap failure path, its one definition taken from option.hpp
+module;
+
+#include <atomic>
+
+#ifdef NAVP_OPTION_CPPTRACE
+#include <cpptrace/cpptrace.hpp>
+#endif
+
+module navp.option;
+
+#define NAVP_OPTION_MODULE
+#define NAVP_OPTION_UNWRAP_DEFINITION
+#include "option.hpp"
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <ranges>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+#include "option_ranges.hpp"
+#include "thread_pool.hpp"
+
+namespace navp {
+
+namespace details {
+
+// elements per block of the tag scan, a fixed trip count loop without branches that the compiler vectorizes
+inline constexpr std::size_t scan_block = 64;
+
+// smallest slice handed to a worker by sequence, below it the task costs more than scanning and moving the slice
+inline constexpr std::size_t sequence_grain = std::size_t{1} << 14;
+
+// smallest slice handed to a worker by traverse, f is expected to cost far more than a tag check
+inline constexpr std::size_t traverse_grain = std::size_t{1} << 8;
+
+// any_none, whether [first, last) holds a None; gives up early, with false, once `stop` is raised by another scan
+template <typename O>
+bool any_none(const O* first, const O* last, const std::atomic<bool>& stop) noexcept {
+  for (; static_cast<std::size_t>(last - first) >= scan_block; first += scan_block) {
+    std::uint32_t nones = 0;
+    for (std::size_t j = 0; j < scan_block; ++j) {
+      nones += first[j].is_none();
+    }
+    if (nones != 0) {
+      return true;
+    }
+    if (stop.load(std::memory_order_relaxed)) {
+      return false;
+    }
+  }
+  for (; first != last; ++first) {
+    if (first->is_none()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// unwrap_into, the payloads of n Options known to be Some, moved or copied into out
+template <bool Move, typename O, typename T>
+void unwrap_into(O* first, std::size_t n, T* out) {
+  if constexpr (std::is_trivially_copyable_v<T> && stores_payload_bytes<std::remove_const_t<O>>) {
+    // the Somes are their payloads byte for byte
+    static_assert(sizeof(O) == sizeof(T));
+    if (n != 0) {
+      std::memcpy(static_cast<void*>(out), static_cast<const void*>(first), n * sizeof(T));
+    }
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = first[i].unwrap_unchecked();
+    }
+  } else if constexpr (Move) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = std::move(first[i]).unwrap();
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = first[i].unwrap();
+    }
+  }
+}
+
+// for_each_chunk, f(lo, hi) over up to four slices per worker of [0, n), the caller runs the first slice itself
+template <typename F>
+void for_each_chunk(ThreadPool& pool, std::size_t n, std::size_t grain, F&& f) {
+  auto chunks = std::min(pool.size() * 4, n / grain);
+  if (chunks <= 1) {
+    f(std::size_t{0}, n);
+    return;
+  }
+  TaskGroup group(pool);
+  for (std::size_t c = 1; c < chunks; ++c) {
+    group.run([&f, lo = c * n / chunks, hi = (c + 1) * n / chunks] { f(lo, hi); });
+  }
+  f(std::size_t{0}, n / chunks);
+  group.wait();
+}
+
+// the payloads of n Options, scanned for a None first, then unwrapped in one pass
+template <bool Move, typename O>
+auto sequence_serial(O* first, std::size_t n) {
+  using _Value = typename std::remove_const_t<O>::value_type;
+  using _Result = Option<std::vector<_Value>>;
+  std::atomic<bool> stop{false};
+  if (any_none(first, first + n, stop)) {
+    return _Result(None);
+  }
+  std::vector<_Value> values;
+  if constexpr (std::is_trivially_copyable_v<_Value> && std::is_default_constructible_v<_Value>) {
+    values.resize(n);
+    unwrap_into<Move>(first, n, values.data());
+  } else {
+    values.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      if constexpr (Move) {
+        values.push_back(std::move(first[i]).unwrap());
+      } else {
+        values.push_back(first[i].unwrap());
+      }
+    }
+  }
+  return _Result(std::in_place, std::move(values));
+}
+
+// the same two passes split across the pool, every scan stops once one of them has seen a None
+// the slices are unwrapped into a presized vector, which needs a default constructible payload
+template <bool Move, typename O>
+auto sequence_parallel(ThreadPool& pool, O* first, std::size_t n) {
+  using _Value = typename std::remove_const_t<O>::value_type;
+  using _Result = Option<std::vector<_Value>>;
+  if constexpr (!std::is_default_constructible_v<_Value> || !std::is_move_assignable_v<_Value>) {
+    return sequence_serial<Move>(first, n);
+  } else {
+    std::atomic<bool> none{false};
+    for_each_chunk(pool, n, sequence_grain, [&](std::size_t lo, std::size_t hi) {
+      if (!none.load(std::memory_order_relaxed) && any_none(first + lo, first + hi, none)) {
+        none.store(true, std::memory_order_relaxed);
+      }
+    });
+    if (none.load(std::memory_order_relaxed)) {
+      return _Result(None);
+    }
+    std::vector<_Value> values(n);
+    for_each_chunk(pool, n, sequence_grain, [&](std::size_t lo, std::size_t hi) {
+      unwrap_into<Move>(first + lo, hi - lo, values.data() + lo);
+    });
+    return _Result(std::in_place, std::move(values));
+  }
+}
+
+template <typename R>
+concept contiguous_option_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && option_range<R>;
+
+template <typename F, typename R>
+using traverse_option_t = std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<R>>>;
+
+// a task for all_some_parallel, called with no argument or with a std::stop_token it may poll to give up early
+template <typename F>
+auto run_task(F& f, const std::stop_source& stop) {
+  if constexpr (std::is_invocable_v<F&, std::stop_token>) {
+    return std::invoke(f, stop.get_token());
+  } else {
+    return std::invoke(f);
+  }
+}
+
+template <typename F>
+using task_option_t = std::remove_cvref_t<decltype(run_task(std::declval<F&>(), std::declval<const std::stop_source&>()))>;
+
+}  // namespace details
+
+// sequence, Some(every payload) or None when any element is None, payloads are moved out as by collect_option
+// a contiguous range has all its tags checked before a single payload is touched, then they are unwrapped in bulk
+template <std::ranges::input_range R>
+  requires details::option_range<R>
+auto sequence(R&& r) {
+  if constexpr (details::contiguous_option_range<R>) {
+    return details::sequence_serial<details::moves_payloads<R>>(std::ranges::data(r), std::ranges::size(r));
+  } else {
+    return collect_option(std::forward<R>(r));
+  }
+}
+
+// sequence on a pool, both the scan and the unwrapping are split across the workers
+template <std::ranges::input_range R>
+  requires details::contiguous_option_range<R>
+auto sequence(ThreadPool& pool, R&& r) {
+  return details::sequence_parallel<details::moves_payloads<R>>(pool, std::ranges::data(r), std::ranges::size(r));
+}
+
+// traverse, Some(payload of f(x) for every x), or None from the first x that f maps to None, f is not called again
+template <std::ranges::input_range R, typename F>
+  requires details::is_instance_of<details::traverse_option_t<F, R>, Option>::value
+auto traverse(R&& r, F f) {
+  using _Value = typename details::traverse_option_t<F, R>::value_type;
+  using _Result = Option<std::vector<_Value>>;
+  std::vector<_Value> values;
+  if constexpr (std::ranges::sized_range<R>) {
+    values.reserve(std::ranges::size(r));
+  }
+  for (auto&& x : r) {
+    auto o = std::invoke(f, std::forward<decltype(x)>(x));
+    if (o.is_none()) {
+      return _Result(None);
+    }
+    values.push_back(std::move(o).unwrap());
+  }
+  return _Result(std::in_place, std::move(values));
+}
+
+// traverse on a pool, f is called concurrently on slices of r and no slice starts another call after a None is seen
+// a payload that is not default constructible falls back to the serial traverse
+template <std::ranges::random_access_range R, typename F>
+  requires std::ranges::sized_range<R> && details::is_instance_of<details::traverse_option_t<F, R>, Option>::value
+auto traverse(ThreadPool& pool, R&& r, F f) {
+  using _Value = typename details::traverse_option_t<F, R>::value_type;
+  using _Result = Option<std::vector<_Value>>;
+  if constexpr (!std::is_default_constructible_v<_Value> || !std::is_move_assignable_v<_Value>) {
+    return traverse(std::forward<R>(r), std::move(f));
+  } else {
+    auto n = static_cast<std::size_t>(std::ranges::size(r));
+    auto first = std::ranges::begin(r);
+    std::atomic<bool> none{false};
+    std::vector<_Value> values(n);
+    details::for_each_chunk(pool, n, details::traverse_grain, [&](std::size_t lo, std::size_t hi) {
+      for (auto i = lo; i < hi && !none.load(std::memory_order_relaxed); ++i) {
+        auto o = std::invoke(f, first[static_cast<std::ranges::range_difference_t<R>>(i)]);
+        if (o.is_none()) {
+          none.store(true, std::memory_order_relaxed);
+          return;
+        }
+        values[i] = std::move(o).unwrap();
+      }
+    });
+    if (none.load(std::memory_order_relaxed)) {
+      return _Result(None);
+    }
+    return _Result(std::in_place, std::move(values));
+  }
+}
+
+// all_some_parallel, Some(tuple of every payload) when every task returns Some, otherwise None
+// the tasks run on the pool, once one returns None (or throws) the tasks not started yet are skipped
+// and the running ones see their std::stop_token stopped, a task polling it may then return None right away
+template <typename... Fs>
+  requires(sizeof...(Fs) > 0 && (details::is_instance_of<details::task_option_t<Fs>, Option>::value && ...))
+auto all_some_parallel(ThreadPool& pool, Fs&&... tasks) {
+  using _Result = Option<std::tuple<typename details::task_option_t<Fs>::value_type...>>;
+  std::stop_source stop;
+  std::tuple<details::task_option_t<Fs>...> results;
+  auto refs = std::forward_as_tuple(tasks...);
+  auto run = [&]<std::size_t I>(std::integral_constant<std::size_t, I>, auto& task) {
+    if (stop.stop_requested()) {
+      return;
+    }
+    try {
+      std::get<I>(results) = details::run_task(task, stop);
+    } catch (...) {
+      stop.request_stop();
+      throw;
+    }
+    if (std::get<I>(results).is_none()) {
+      stop.request_stop();
+    }
+  };
+  return [&]<std::size_t... I>(std::index_sequence<I...>) {
+    {
+      TaskGroup group(pool);
+      // every task but the first goes to the pool, the caller runs the first one meanwhile
+      ((I != 0 ? group.run([&] { run(std::integral_constant<std::size_t, I>{}, std::get<I>(refs)); }) : void()), ...);
+      run(std::integral_constant<std::size_t, 0>{}, std::get<0>(refs));
+      group.wait();
+    }
+    if (stop.stop_requested()) {
+      return _Result(None);
+    }
+    return _Result(std::in_place, std::move(std::get<I>(results)).unwrap()...);
+  }(std::index_sequence_for<Fs...>{});
+}
+
+// first_some_parallel, f(x) for the first x of r, in order, that f maps to Some, or None when there is none
+// the workers claim elements one at a time in order, so once a Some is found no element after it is started,
+// the elements before it still run to keep the answer the same as a serial search
+template <std::ranges::random_access_range R, typename F>
+  requires std::ranges::sized_range<R> && details::is_instance_of<details::traverse_option_t<F, R>, Option>::value
+auto first_some_parallel(ThreadPool& pool, R&& r, F f) {
+  using _Option = details::traverse_option_t<F, R>;
+  auto n = static_cast<std::size_t>(std::ranges::size(r));
+  auto first = std::ranges::begin(r);
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> found{n};
+  std::mutex lock;
+  _Option best;
+  auto work = [&] {
+    for (;;) {
+      auto i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= found.load(std::memory_order_relaxed)) {
+        return;
+      }
+      auto o = std::invoke(f, first[static_cast<std::ranges::range_difference_t<R>>(i)]);
+      if (o.is_some()) {
+        std::lock_guard guard(lock);
+        if (i < found.load(std::memory_order_relaxed)) {
+          best = std::move(o);
+          found.store(i, std::memory_order_relaxed);
+        }
+      }
+    }
+  };
+  {
+    TaskGroup group(pool);
+    for (std::size_t k = 1; k < std::min(pool.size() + 1, n); ++k) {
+      group.run(work);
+    }
+    work();
+    group.wait();
+  }
+  return best;
+}
+
+}  // namespace navp
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+
+namespace navp {
+
+namespace details {
+
+template <typename R>
+concept option_range = std::ranges::input_range<R> &&
+                       is_instance_of<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Option>::value;
+
+// whether the payloads can be moved out of r: the Options are temporaries, or r is an owning container passed as an rvalue
+template <typename R>
+inline constexpr bool moves_payloads = !std::is_lvalue_reference_v<std::ranges::range_reference_t<R>> ||
+                                       (!std::is_lvalue_reference_v<R> && !std::ranges::view<std::remove_cvref_t<R>>);
+
+// the Some payloads of a range of Options, skipping the Nones or stopping at the first one
+// each element is read once; when the base yields Options by value, the current one is kept in the iterator
+template <std::ranges::view V, bool StopAtNone>
+  requires option_range<V>
+class unwrap_view : public std::ranges::view_interface<unwrap_view<V, StopAtNone>> {
+  using _Ref = std::ranges::range_reference_t<V>;
+  using _Option = std::remove_cvref_t<_Ref>;
+  using _Value = typename _Option::value_type;
+  static constexpr bool _s_cache = !std::is_lvalue_reference_v<_Ref>;
+  static constexpr bool _s_forward = !_s_cache && std::ranges::forward_range<V>;
+
+  struct _NoCache {};
+
+  class _Iterator {
+   public:
+    using iterator_concept = std::conditional_t<_s_forward, std::forward_iterator_tag, std::input_iterator_tag>;
+    using value_type = _Value;
+    using difference_type = std::ranges::range_difference_t<V>;
+
+    _Iterator() = default;
+    constexpr _Iterator(unwrap_view& parent, std::ranges::iterator_t<V> current)
+        : _m_parent(&parent), _m_current(std::move(current)) {
+      _m_satisfy();
+    }
+
+    constexpr decltype(auto) operator*() const {
+      if constexpr (_s_cache) {
+        return _m_cache.unwrap();
+      } else {
+        return (*_m_current).unwrap();
+      }
+    }
+
+    constexpr _Iterator& operator++() {
+      ++_m_current;
+      _m_satisfy();
+      return *this;
+    }
+    constexpr void operator++(int)
+      requires(!_s_forward)
+    {
+      ++*this;
+    }
+    constexpr _Iterator operator++(int)
+      requires _s_forward
+    {
+      auto old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend constexpr bool operator==(const _Iterator& x, const _Iterator& y)
+      requires std::equality_comparable<std::ranges::iterator_t<V>>
+    {
+      return x._m_current == y._m_current && x._m_stopped == y._m_stopped;
+    }
+    friend constexpr bool operator==(const _Iterator& x, std::default_sentinel_t) { return x._m_at_end(); }
+
+   private:
+    constexpr bool _m_at_end() const { return _m_stopped || _m_current == std::ranges::end(_m_parent->_m_base); }
+
+    constexpr void _m_satisfy() {
+      for (auto end = std::ranges::end(_m_parent->_m_base); _m_current != end; ++_m_current) {
+        if constexpr (_s_cache) {
+          _m_cache = *_m_current;
+          if (_m_cache.is_some()) {
+            return;
+          }
+        } else if ((*_m_current).is_some()) {
+          return;
+        }
+        if constexpr (StopAtNone) {
+          _m_stopped = true;
+          return;
+        }
+      }
+    }
+
+    unwrap_view* _m_parent = nullptr;
+    std::ranges::iterator_t<V> _m_current{};
+    bool _m_stopped = false;
+    [[no_unique_address]] mutable std::conditional_t<_s_cache, _Option, _NoCache> _m_cache{};
+  };
+
+ public:
+  unwrap_view()
+    requires std::default_initializable<V>
+  = default;
+  constexpr explicit unwrap_view(V base) : _m_base(std::move(base)) {}
+
+  constexpr V base() const&
+    requires std::copy_constructible<V>
+  {
+    return _m_base;
+  }
+  constexpr V base() && { return std::move(_m_base); }
+
+  constexpr _Iterator begin() { return _Iterator(*this, std::ranges::begin(_m_base)); }
+  constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+ private:
+  V _m_base = V();
+};
+
+// a range adaptor object, callable on a range and usable after a pipe
+template <bool StopAtNone>
+struct unwrap_adaptor {
+  template <std::ranges::viewable_range R>
+    requires option_range<R>
+  constexpr auto operator()(R&& r) const {
+    return unwrap_view<std::views::all_t<R>, StopAtNone>(std::views::all(std::forward<R>(r)));
+  }
+
+  template <std::ranges::viewable_range R>
+    requires option_range<R>
+  friend constexpr auto operator|(R&& r, const unwrap_adaptor& self) {
+    return self(std::forward<R>(r));
+  }
+};
+
+}  // namespace details
+
+namespace views {
+
+// somes, the payload of every Some, Nones are skipped
+inline constexpr details::unwrap_adaptor<false> somes{};
+
+// take_while_some, the payloads up to the first None
+inline constexpr details::unwrap_adaptor<true> take_while_some{};
+
+}  // namespace views
+
+// collect_option, Some(vector of every payload), or None as soon as one element is None
+// payloads are moved out of Options yielded by value and out of a container passed as an rvalue
+template <std::ranges::input_range R>
+  requires details::option_range<R>
+constexpr auto collect_option(R&& r) {
+  using _Ref = std::ranges::range_reference_t<R>;
+  using _Value = typename std::remove_cvref_t<_Ref>::value_type;
+  using _Result = Option<std::vector<_Value>>;
+  std::vector<_Value> values;
+  if constexpr (std::ranges::sized_range<R>) {
+    values.reserve(std::ranges::size(r));
+  }
+  for (auto&& o : r) {
+    if (o.is_none()) {
+      return _Result(None);
+    }
+    if constexpr (details::moves_payloads<R>) {
+      values.push_back(std::move(o).unwrap());
+    } else {
+      values.push_back(o.unwrap());
+    }
+  }
+  return _Result(std::in_place, std::move(values));
+}
+
+}  // namespace navp
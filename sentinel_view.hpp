@@ -0,0 +1,191 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "option.hpp"
+#include "option_column.hpp"
+
+namespace navp {
+
+// predicates telling which raw values mean "missing"
+// is_sentinel<V> : the value V, e.g. -1 or 0xffff
+// is_nan         : any nan, a nan never equals itself
+template <auto V>
+struct is_sentinel {
+  template <typename T>
+  constexpr bool operator()(const T& val) const noexcept {
+    return val == static_cast<T>(V);
+  }
+};
+
+struct is_nan {
+  template <typename T>
+  constexpr bool operator()(const T& val) const noexcept {
+    return val != val;
+  }
+};
+
+// SentinelView, a non-owning view over raw values where Pred(value) marks a None
+// elements are read as Options on the fly, nothing is copied or materialized
+// the bulk queries work on blocks of 64 elements with a fixed trip count, which the compiler vectorizes
+template <typename T, typename Pred = is_sentinel<-1>>
+class SentinelView {
+ public:
+  class iterator {
+   public:
+    using value_type = Option<const T&>;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+
+    value_type operator*() const noexcept { return (*_m_view)[_m_index]; }
+
+    iterator& operator++() noexcept {
+      ++_m_index;
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      auto old = *this;
+      ++_m_index;
+      return old;
+    }
+
+    bool operator==(const iterator& rhs) const noexcept { return _m_index == rhs._m_index; }
+
+   private:
+    friend class SentinelView;
+    iterator(const SentinelView* view, std::size_t index) noexcept : _m_view(view), _m_index(index) {}
+
+    const SentinelView* _m_view = nullptr;
+    std::size_t _m_index = 0;
+  };
+
+  constexpr SentinelView() noexcept = default;
+  constexpr SentinelView(const T* data, std::size_t size, Pred pred = Pred()) noexcept
+      : _m_data(data), _m_size(size), _m_pred(pred) {}
+  constexpr explicit SentinelView(std::span<const T> values, Pred pred = Pred()) noexcept
+      : SentinelView(values.data(), values.size(), pred) {}
+
+  constexpr const T* data() const noexcept { return _m_data; }
+  constexpr std::size_t size() const noexcept { return _m_size; }
+  constexpr bool empty() const noexcept { return _m_size == 0; }
+
+  // is_some, is_none
+  constexpr bool is_some(std::size_t i) const noexcept { return !_m_pred(_m_data[i]); }
+  constexpr bool is_none(std::size_t i) const noexcept { return _m_pred(_m_data[i]); }
+
+  // element access, a reference into the viewed values
+  constexpr Option<const T&> operator[](std::size_t i) const noexcept {
+    return is_some(i) ? Option<const T&>(_m_data[i]) : None;
+  }
+
+  // get, the element by value
+  constexpr Option<T> get(std::size_t i) const noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return is_some(i) ? Option<T>(std::in_place, _m_data[i]) : None;
+  }
+
+  iterator begin() const noexcept { return iterator(this, 0); }
+  iterator end() const noexcept { return iterator(this, _m_size); }
+
+  // count_some
+  std::size_t count_some() const noexcept {
+    std::size_t count = 0;
+    std::size_t first = 0;
+    for (; _m_size - first >= _s_block; first += _s_block) {
+      count += _s_block - _m_block_nones(first);
+    }
+    return count + static_cast<std::size_t>(std::popcount(_m_some_bits(first)));
+  }
+
+  // find_first_none, the index of the first None
+  Option<std::size_t> find_first_none() const noexcept {
+    for (std::size_t first = 0; first < _m_size; first += _s_block) {
+      if (_m_block_size(first) == _s_block && _m_block_nones(first) == 0) {
+        continue;
+      }
+      auto bits = _m_some_bits(first);
+      if (bits != _s_full(_m_block_size(first))) {
+        return first + static_cast<std::size_t>(std::countr_one(bits));
+      }
+    }
+    return None;
+  }
+
+  // some_bits, the presence bitmap, bit i % 64 of word i / 64 is set when element i is Some
+  std::vector<std::uint64_t> some_bits() const {
+    std::vector<std::uint64_t> bits((_m_size + _s_block - 1) / _s_block);
+    for (std::size_t w = 0; w < bits.size(); ++w) {
+      bits[w] = _m_some_bits(w * _s_block);
+    }
+    return bits;
+  }
+
+  // to_column, copies the Some values into an OptionColumn without building an Option per element
+  OptionColumn<T> to_column() const { return OptionColumn<T>(std::span<const T>(_m_data, _m_size), some_bits()); }
+
+ private:
+  static constexpr std::size_t _s_block = 64;
+
+  static constexpr std::uint64_t _s_full(std::size_t n) noexcept {
+    return n == _s_block ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+  }
+
+  std::size_t _m_block_size(std::size_t first) const noexcept {
+    return _m_size - first < _s_block ? _m_size - first : _s_block;
+  }
+
+  // Nones in the full block at first, counted without branches so the loop vectorizes
+  std::uint32_t _m_block_nones(std::size_t first) const noexcept {
+    std::uint32_t nones = 0;
+    for (std::size_t j = 0; j < _s_block; ++j) {
+      nones += _m_pred(_m_data[first + j]);
+    }
+    return nones;
+  }
+
+  // bit j set when element first + j is Some
+  // a full block is compared into a byte per element first, a loop without a carried dependency that vectorizes
+  // like _m_block_nones, then the bytes are packed eight at a time
+  std::uint64_t _m_some_bits(std::size_t first) const noexcept {
+    const T* block = _m_data + first;
+    auto n = _m_block_size(first);
+    if (n != _s_block) {
+      std::uint64_t bits = 0;
+      for (std::size_t j = 0; j < n; ++j) {
+        bits |= std::uint64_t{!_m_pred(block[j])} << j;
+      }
+      return bits;
+    }
+    alignas(8) std::uint8_t somes[_s_block];
+    for (std::size_t j = 0; j < _s_block; ++j) {
+      somes[j] = !_m_pred(block[j]);
+    }
+    std::uint64_t bits = 0;
+    for (std::size_t w = 0; w < _s_block / 8; ++w) {
+      std::uint64_t bytes;
+      std::memcpy(&bytes, somes + w * 8, 8);
+      if constexpr (std::endian::native == std::endian::big) {
+        bytes = std::byteswap(bytes);
+      }
+      bits |= _s_pack(bytes) << (w * 8);
+    }
+    return bits;
+  }
+
+  // eight bytes of 0 or 1 into eight bits, byte i to bit i: the multiply moves byte i's bit to bit 56 + i,
+  // and every other partial product lands on a distinct lower bit, so nothing carries into the top byte
+  static constexpr std::uint64_t _s_pack(std::uint64_t bytes) noexcept {
+    return (bytes * 0x0102'0408'1020'4080ull) >> 56;
+  }
+
+  const T* _m_data = nullptr;
+  std::size_t _m_size = 0;
+  [[no_unique_address]] Pred _m_pred{};
+};
+
+}  // namespace navp
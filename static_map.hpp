@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+namespace navp {
+
+// static_hash, the 64-bit hash StaticMap builds its perfect hash from, specialize it for other key types:
+//   template <> struct navp::static_hash<Point> { static constexpr std::uint64_t hash(const Point& p) noexcept; };
+// it must give the same value in constant evaluation and at run time
+template <typename K>
+struct static_hash;
+
+namespace details {
+
+// the splitmix64 finalizer, every input bit reaches every output bit
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xbf58'476d'1ce4'e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d0'49bb'1331'11ebull;
+  return x ^ (x >> 31);
+}
+
+// eight bytes at a time, assembled with shifts so it also runs in constant evaluation,
+// the compiler turns the assembly into a single load at run time
+constexpr std::uint64_t hash_bytes(std::string_view s) noexcept {
+  std::uint64_t h = 0x9e37'79b9'7f4a'7c15ull ^ s.size();
+  std::size_t i = 0;
+  for (; i + 8 <= s.size(); i += 8) {
+    std::uint64_t word = 0;
+    for (std::size_t j = 0; j < 8; ++j) {
+      word |= std::uint64_t(static_cast<unsigned char>(s[i + j])) << (8 * j);
+    }
+    h = std::rotl((h ^ word) * 0x9e37'79b9'7f4a'7c15ull, 29);
+  }
+  std::uint64_t tail = 0;
+  for (std::size_t j = 0; i + j < s.size(); ++j) {
+    tail |= std::uint64_t(static_cast<unsigned char>(s[i + j])) << (8 * j);
+  }
+  return mix64(h ^ tail);
+}
+
+}  // namespace details
+
+template <typename K>
+  requires std::integral<K> || std::is_enum_v<K>
+struct static_hash<K> {
+  static constexpr std::uint64_t hash(K key) noexcept { return details::mix64(static_cast<std::uint64_t>(key)); }
+};
+
+template <>
+struct static_hash<std::string_view> {
+  static constexpr std::uint64_t hash(std::string_view key) noexcept { return details::hash_bytes(key); }
+};
+
+// read-only hash map built by the compiler, for tables of static configuration that are only ever queried:
+//   constexpr auto ports = navp::make_static_map<std::string_view, int>({{"http", 80}, {"https", 443}});
+//   ports.find("https")  // Option<const int&>, no allocation and no probing
+// the perfect hash is hash and displace: a key's 64-bit hash picks a bucket, the bucket's displacement picks the slot,
+// and the displacements are searched at build time so that no two keys share a slot
+// a lookup is one hash, two loads and one key comparison; duplicate keys fail the build
+template <typename K, typename V, std::size_t N>
+class StaticMap {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+
+  // a load factor of 0.8 at most keeps the displacement search short at build time
+  static constexpr std::size_t slot_count = std::max<std::size_t>(std::bit_ceil(N + N / 4), 2);
+  static constexpr std::size_t bucket_count = N / 2 + 1;
+
+  constexpr explicit StaticMap(const std::array<value_type, N>& entries) : _m_entries(entries), _m_slots() {
+    _m_build();
+  }
+
+  // find, the value of key, or None
+  constexpr Option<const V&> find(const K& key) const noexcept {
+    auto h = static_hash<K>::hash(key);
+    auto slot = _m_slots[_m_slot_of(h)];
+    if (slot.is_some() && _m_entries[slot.unwrap_unchecked()].first == key) {
+      return _m_entries[slot.unwrap_unchecked()].second;
+    }
+    return None;
+  }
+
+  constexpr bool contains(const K& key) const noexcept { return find(key).is_some(); }
+
+  constexpr std::size_t size() const noexcept { return N; }
+  constexpr bool empty() const noexcept { return N == 0; }
+
+  // the entries in the order they were given
+  constexpr auto begin() const noexcept { return _m_entries.begin(); }
+  constexpr auto end() const noexcept { return _m_entries.end(); }
+
+ private:
+  using _Index = Option<std::uint32_t, Sentinel<-1>>;
+
+  static constexpr int _s_slot_shift = 64 - std::countr_zero(slot_count);
+
+  constexpr std::size_t _m_slot_of(std::uint64_t h) const noexcept {
+    // the bucket comes from the high half of the hash, the slot from the whole of it mixed with the displacement
+    auto bucket = static_cast<std::size_t>(((h >> 32) * bucket_count) >> 32);
+    return static_cast<std::size_t>(((h ^ _m_displacement[bucket]) * 0x9e37'79b9'7f4a'7c15ull) >> _s_slot_shift);
+  }
+
+  constexpr void _m_build() {
+    static_assert(N < 0xffff'ffffu, "the slots index entries with 32 bits");
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::uint32_t, bucket_count + 1> bucket_start{};
+    for (std::size_t i = 0; i < N; ++i) {
+      hashes[i] = static_hash<K>::hash(_m_entries[i].first);
+      ++bucket_start[((hashes[i] >> 32) * bucket_count) >> 32];
+    }
+    // counting sort of the entries by bucket, then the buckets by size, largest first
+    std::array<std::uint32_t, bucket_count> order{};
+    for (std::size_t b = 0; b < bucket_count; ++b) {
+      order[b] = static_cast<std::uint32_t>(b);
+    }
+    std::sort(order.begin(), order.end(),
+              [&](std::uint32_t a, std::uint32_t b) { return bucket_start[a] > bucket_start[b]; });
+    std::uint32_t sum = 0;
+    for (auto& start : bucket_start) {
+      auto size = start;
+      start = sum;
+      sum += size;
+    }
+    std::array<std::uint32_t, N> members{};
+    std::array<std::uint32_t, bucket_count + 1> fill = bucket_start;
+    for (std::size_t i = 0; i < N; ++i) {
+      members[fill[((hashes[i] >> 32) * bucket_count) >> 32]++] = static_cast<std::uint32_t>(i);
+    }
+
+    std::array<bool, slot_count> taken{};
+    for (auto b : order) {
+      auto first = bucket_start[b], last = bucket_start[b + 1];
+      if (first == last) {
+        break;
+      }
+      // two keys of a bucket with the same hash never separate, those are duplicates or a weak static_hash
+      for (auto i = first; i < last; ++i) {
+        for (auto j = i + 1; j < last; ++j) {
+          if (hashes[members[i]] == hashes[members[j]]) {
+            throw std::invalid_argument(_m_entries[members[i]].first == _m_entries[members[j]].first
+                                            ? "StaticMap: duplicate key"
+                                            : "StaticMap: two keys with the same hash");
+          }
+        }
+      }
+      for (std::uint64_t attempt = 0;; ++attempt) {
+        if (attempt == (std::uint64_t(1) << 24)) {
+          throw std::invalid_argument("StaticMap: no displacement found for a bucket");
+        }
+        _m_displacement[b] = details::mix64(attempt);
+        auto placed = first;
+        for (; placed < last; ++placed) {
+          auto slot = _m_slot_of(hashes[members[placed]]);
+          if (taken[slot]) {
+            break;
+          }
+          taken[slot] = true;
+          _m_slots[slot] = members[placed];
+        }
+        if (placed == last) {
+          break;
+        }
+        for (auto undo = first; undo < placed; ++undo) {
+          auto slot = _m_slot_of(hashes[members[undo]]);
+          taken[slot] = false;
+          _m_slots[slot] = None;
+        }
+      }
+    }
+  }
+
+  std::array<value_type, N> _m_entries;
+  std::array<_Index, slot_count> _m_slots;
+  std::array<std::uint64_t, bucket_count> _m_displacement{};
+};
+
+// make_static_map, deduces the size from a braced list of key value pairs
+template <typename K, typename V, std::size_t N>
+constexpr StaticMap<K, V, N> make_static_map(const std::pair<K, V> (&entries)[N]) {
+  return StaticMap<K, V, N>(std::to_array(entries));
+}
+
+template <typename K, typename V, std::size_t N>
+constexpr StaticMap<K, V, N> make_static_map(const std::array<std::pair<K, V>, N>& entries) {
+  return StaticMap<K, V, N>(entries);
+}
+
+}  // namespace navp
@@ -1,10 +1,42 @@
 #include <cassert>
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <optional>
+#include <queue>
+#include <ranges>
+#include <set>
+#include <span>
+#include <stack>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <variant>
 
 #include "doctest.h"
+#include "mpmc_queue.hpp"
 #include "option.hpp"
+#include "option_boxed.hpp"
+#include "option_cache.hpp"
+#include "option_column.hpp"
+#include "option_coroutine.hpp"
+#include "option_lookup.hpp"
+#include "option_parallel.hpp"
+#include "option_ranges.hpp"
+#include "sentinel_view.hpp"
+#include "static_map.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_deque.hpp"
 
 using navp::None;
 using navp::Option;
@@ -69,6 +101,504 @@ TEST_CASE("Size") {
   static_assert(sizeof(Option<ComplexT>) == sizeof(std::optional<ComplexT>));
 }
 
+// NanBoxed
+TEST_CASE("NanBoxed") {
+  using navp::NanBoxed;
+  static_assert(sizeof(Option<double, NanBoxed>) == 8);
+  static_assert(sizeof(Option<float, NanBoxed>) == 4);
+  static_assert(std::is_trivially_copyable_v<Option<double, NanBoxed>>);
+  static_assert(Option<double, NanBoxed>(1.5).unwrap() == 1.5);
+  static_assert(Option<double, NanBoxed>().is_none());
+
+  auto round_trip = [](auto val) {
+    using F = decltype(val);
+    using Bits = std::conditional_t<sizeof(F) == 4, std::uint32_t, std::uint64_t>;
+    Option<F, NanBoxed> o = val;
+    REQUIRE(o.is_some());
+    CHECK(std::bit_cast<Bits>(o.unwrap()) == std::bit_cast<Bits>(val));
+    Option<F, NanBoxed> copy = o;
+    CHECK(std::bit_cast<Bits>(copy.unwrap()) == std::bit_cast<Bits>(val));
+  };
+  auto every_class = [&](auto zero) {
+    using F = decltype(zero);
+    using Bits = std::conditional_t<sizeof(F) == 4, std::uint32_t, std::uint64_t>;
+    using limits = std::numeric_limits<F>;
+    constexpr Bits exponent = sizeof(F) == 4 ? 0x7f80'0000u : 0x7ff0'0000'0000'0000ull;
+    constexpr Bits quiet = sizeof(F) == 4 ? 0x0040'0000u : 0x0008'0000'0000'0000ull;
+    constexpr Bits sign = Bits(1) << (sizeof(F) * 8 - 1);
+    round_trip(limits::quiet_NaN());
+    round_trip(-limits::quiet_NaN());
+    round_trip(limits::signaling_NaN());
+    round_trip(std::bit_cast<F>(exponent | quiet | 0x1234));           // quiet nan with payload
+    round_trip(std::bit_cast<F>(exponent | 1));                        // smallest signaling payload
+    round_trip(std::bit_cast<F>(exponent | 0x4e46));                   // neighbour of the None pattern
+    round_trip(std::bit_cast<F>(sign | exponent | 0x4e45));            // None pattern with the sign bit set
+    round_trip(std::bit_cast<F>(exponent | (quiet - 1)));              // largest signaling payload
+    round_trip(limits::infinity());
+    round_trip(-limits::infinity());
+    round_trip(limits::denorm_min());
+    round_trip(F(0));
+    round_trip(-F(0));
+    round_trip(limits::max());
+  };
+  every_class(0.0);
+  every_class(0.0f);
+
+  Option<double, NanBoxed> o = None;
+  CHECK(o.is_none());
+  CHECK(o.unwrap_or(2.0) == 2.0);
+  o.insert(3.0);
+  CHECK(o.map_or([](double d) { return d * 2; }, 0.0) == 6.0);
+  Option<double> tagged = o;
+  CHECK(tagged == Some(3.0));
+  o = None;
+  CHECK(o == None);
+  CHECK_THROWS(o.unwrap());
+}
+
+TEST_CASE("Sentinel") {
+  using navp::Sentinel;
+  using Int = Option<int, Sentinel<std::numeric_limits<int>::min()>>;
+  using Index = Option<std::uint32_t, Sentinel<-1>>;
+  static_assert(sizeof(Int) == sizeof(int) && alignof(Int) == alignof(int));
+  static_assert(sizeof(Index) == 4);
+  static_assert(std::is_standard_layout_v<Int> && std::is_trivially_copyable_v<Int>);
+  static_assert(sizeof(Option<int*, Sentinel<nullptr>>) == sizeof(int*));
+  static_assert(Int(7).unwrap() == 7);
+  static_assert(Int().is_none());
+  static_assert(Index().is_none() && Index(0u).is_some());
+
+  // an array of Option is an array of raw ints, the sentinel reads back as None
+  constexpr std::array<int, 4> raw{1, std::numeric_limits<int>::min(), 0, -1};
+  constexpr auto opts = std::bit_cast<std::array<Int, 4>>(raw);
+  static_assert(opts[0] == Some(1) && opts[1].is_none() && opts[2] == Some(0) && opts[3] == Some(-1));
+  static_assert(std::bit_cast<std::array<int, 4>>(opts) == raw);
+
+  Int o = None;
+  CHECK(o.is_none());
+  CHECK(o.unwrap_or(2) == 2);
+  o.insert(3);
+  CHECK(o.map_or([](int i) { return i * 2; }, 0) == 6);
+  CHECK(o.replace(5) == 5);
+  CHECK(o == Some(5));
+  o = Some(4);
+  Option<Int> nested = o;
+  CHECK(nested.is_some());
+  CHECK(nested.flatten() == Some(4));
+  Option<int> tagged = o;
+  CHECK(tagged == Some(4));
+  o = None;
+  CHECK(o == None);
+  CHECK_THROWS(o.unwrap());
+
+  Index idx = 0xfffffffeu;
+  CHECK(idx.unwrap() == 0xfffffffeu);
+}
+
+TEST_CASE("Null Niche") {
+  using navp::Tagged;
+  static_assert(sizeof(Option<int*>) == sizeof(int*));
+  static_assert(sizeof(Option<void (*)()>) == sizeof(void (*)()));
+  static_assert(sizeof(Option<std::unique_ptr<int>>) == sizeof(std::unique_ptr<int>));
+  static_assert(sizeof(Option<std::shared_ptr<int>>) == sizeof(std::shared_ptr<int>));
+  // a null data() is a valid empty view, so views keep a tag
+  static_assert(sizeof(Option<std::span<int>>) > sizeof(std::span<int>));
+  static_assert(sizeof(Option<std::string_view>) > sizeof(std::string_view));
+  static_assert(sizeof(Option<int*, Tagged>) == 2 * sizeof(int*));
+  static_assert(std::is_trivially_copyable_v<Option<std::string_view>>);
+  static_assert(!std::is_copy_constructible_v<Option<std::unique_ptr<int>>>);
+  static_assert(Option<const char*>().is_none());
+  static_assert(Option<const char*>("Hello").is_some());
+
+  int i = 42;
+  Option<int*> p = &i;
+  CHECK(*p.unwrap() == 42);
+  p = None;
+  CHECK(p.is_none());
+
+  // the Tagged layout keeps a Some holding null
+  Option<int*, Tagged> nullable = static_cast<int*>(nullptr);
+  CHECK(nullable.is_some());
+  CHECK(nullable.unwrap() == nullptr);
+
+  Option<std::unique_ptr<int>> owner = std::make_unique<int>(7);
+  CHECK(*owner.unwrap() == 7);
+  auto other = std::move(owner);
+  CHECK(*other.unwrap() == 7);
+  CHECK(owner.is_none());
+  other = None;
+  CHECK(other.is_none());
+
+  auto shared = std::make_shared<int>(3);
+  Option<std::shared_ptr<int>> s1 = shared;
+  auto s2 = s1;
+  CHECK(shared.use_count() == 3);
+  s1 = None;
+  CHECK(shared.use_count() == 2);
+  CHECK(*s2.unwrap() == 3);
+
+  std::string_view empty = "";
+  Option<std::string_view> sv = empty;
+  CHECK(sv.is_some());
+  CHECK(sv.unwrap().empty());
+  sv = std::string_view("Hello Option!");
+  CHECK(sv.unwrap() == "Hello Option!");
+  CHECK(Option<std::string_view>().is_none());
+  CHECK(Some(std::string_view{}).is_some());
+  CHECK(Option<std::string_view>(std::string_view{}).unwrap().empty());
+
+  int values[3] = {1, 2, 3};
+  Option<std::span<int>> view = std::span<int>(values);
+  CHECK(view.unwrap().size() == 3);
+  CHECK(Option<std::span<int>>().is_none());
+  std::vector<int> no_values;
+  CHECK(Some(std::span<int>(no_values)).is_some());
+  CHECK(Some(std::span<const int>(std::vector<int>{})).is_some());
+
+  // the single spare state is used up, the enclosing Option adds a tag
+  static_assert(sizeof(Option<Option<int*>>) == 2 * sizeof(int*));
+  Option<Option<int*>> nested(std::in_place, None);
+  CHECK(nested.is_some());
+  CHECK(nested.flatten().is_none());
+}
+
+// nested Option reuses the inner discriminant
+TEST_CASE("Nested") {
+  static_assert(sizeof(Option<Option<int>>) == sizeof(Option<int>));
+  static_assert(sizeof(Option<Option<Option<int>>>) == sizeof(Option<int>));
+  static_assert(sizeof(Option<Option<std::string>>) == sizeof(Option<std::string>));
+  static_assert(std::is_trivially_copyable_v<Option<Option<int>>>);
+  static_assert(Option<Option<int>>().is_none());
+  static_assert(Option<Option<int>>(std::in_place, None).is_some());
+  static_assert(Option<Option<int>>(std::in_place, 1).unwrap().unwrap() == 1);
+
+  using OO = Option<Option<int>>;
+  OO none;
+  OO some_none{std::in_place, None};
+  OO some_some{std::in_place, 42};
+  CHECK(none.is_none());
+  CHECK(some_none.is_some());
+  CHECK(some_none.unwrap().is_none());
+  CHECK(some_some.unwrap().unwrap() == 42);
+
+  OO copy = none;
+  CHECK(copy.is_none());
+  copy = some_none;
+  CHECK(copy.is_some());
+  copy = None;
+  CHECK(copy.is_none());
+  copy.insert(7);
+  CHECK(copy.unwrap() == Some(7));
+
+  // an inner Option is a payload, it is wrapped and never converted level by level
+  static_assert(OO{Option<int>(None)}.is_some());
+  OO wrapped = Option<int>(None);
+  CHECK(wrapped.is_some());
+  CHECK(wrapped.unwrap().is_none());
+  CHECK(OO{Option<int>(None)}.unwrap().is_none());
+  CHECK(OO{Option<int>(3)}.unwrap() == Some(3));
+  copy = Option<int>(None);
+  CHECK(copy.is_some());
+  CHECK(Option<long>(Option<int>(5)) == Some(5L));
+
+  CHECK(none.flatten().is_none());
+  CHECK(some_none.flatten().is_none());
+  CHECK(some_some.flatten() == Some(42));
+  static_assert(std::is_same_v<decltype(std::move(some_some).flatten()), Option<int>>);
+
+  using OOO = Option<Option<Option<int>>>;
+  OOO n3;
+  OOO s3{std::in_place, None};
+  OOO ss3{std::in_place, std::in_place, None};
+  CHECK(n3.is_none());
+  CHECK(s3.is_some());
+  CHECK(s3.unwrap().is_none());
+  CHECK(ss3.unwrap().is_some());
+  CHECK(ss3.unwrap().unwrap().is_none());
+  CHECK(ss3.flatten().flatten().is_none());
+
+  Option<Option<std::string>> os{std::in_place, std::string("Hello Option!")};
+  auto os2 = os;
+  CHECK(os2.unwrap().unwrap() == "Hello Option!");
+  os2 = None;
+  CHECK(os2.is_none());
+  os2 = os;
+  CHECK(std::move(os2).flatten() == Some(std::string("Hello Option!")));
+
+  // std::variant keeps its discriminant private, so it is only accepted, not merged
+  using V = std::variant<int, std::string>;
+  Option<V> ov = V(std::string("variant"));
+  CHECK(std::get<std::string>(ov.unwrap()) == "variant");
+  ov = None;
+  CHECK(ov.is_none());
+}
+
+// bool and enums keep None in an unused value
+enum class Light : std::uint8_t { Red, Yellow, Green, max_value = Green };
+enum class Level : std::int8_t { Low = -1, Mid, High };
+enum class Unit : char8_t { Byte, Kilo, Mega };
+enum class Code : int { Ok, Retry, Fail };
+enum Plain : unsigned char { PlainA, PlainB };
+template <>
+struct navp::enum_max<Level> {
+  static constexpr Level value = Level::High;
+};
+template <>
+struct navp::enum_max<Unit> {
+  static constexpr Unit value = Unit::Mega;
+};
+template <>
+struct navp::enum_max<Code> {
+  static constexpr Code value = Code::Fail;
+};
+template <>
+struct navp::enum_max<Plain> {
+  static constexpr Plain value = PlainB;
+};
+
+TEST_CASE("Compact Bool Enum") {
+  using Bool = Option<bool, navp::Packed>;
+  static_assert(sizeof(Bool) == 1);
+  static_assert(sizeof(Option<Bool>) == 1);
+  static_assert(sizeof(Option<bool>) == 2);
+  static_assert(sizeof(Option<Option<bool>>) == 2);
+  // the default Option<bool> is Tagged, which constant evaluation can read
+  static_assert(std::is_same_v<navp::details::option_storage_t<bool, navp::Compact>,
+                               navp::details::option_storage<bool, navp::Tagged>>);
+  static constexpr Option<bool> yes(true);
+  static_assert(yes.unwrap());
+  static_assert(Option<bool>(false) == Some(false));
+  static_assert(Option<bool>().is_none());
+  static_assert(sizeof(Option<Light>) == 1);
+  static_assert(sizeof(Option<Level>) == 1);
+  static_assert(sizeof(Option<Unit>) == 1);
+  static_assert(sizeof(Option<Plain>) == 1);
+  static_assert(sizeof(Option<Code>) == sizeof(Code));
+  static_assert(sizeof(Option<Option<Light>>) == 1);
+  // every value is taken, these keep the tag
+  static_assert(sizeof(Option<std::byte>) == 2);
+  static_assert(sizeof(Option<char8_t>) == 2);
+  static_assert(Option<Light>(Light::Green).unwrap() == Light::Green);
+  static_assert(Option<Level>().is_none());
+
+  Bool b;
+  CHECK(b.is_none());
+  b = true;
+  CHECK(b == Some(true));
+  b.insert(false);
+  CHECK(b.is_some());
+  CHECK(b.unwrap() == false);
+  b.unwrap() = true;
+  CHECK(b.unwrap());
+  b = None;
+  CHECK(b.unwrap_or(false) == false);
+  Option<Bool> bb{std::in_place, None};
+  CHECK(bb.is_some());
+  CHECK(bb.unwrap().is_none());
+  bb = None;
+  CHECK(bb.is_none());
+  bb.insert(false);
+  CHECK(bb.flatten() == Some(false));
+
+  Option<Level> level = Level::Low;
+  CHECK(level.unwrap() == Level::Low);
+  level = Level::High;
+  CHECK(level.unwrap() == Level::High);
+  level = None;
+  CHECK(level.is_none());
+
+  for (auto unit : {Unit::Byte, Unit::Kilo, Unit::Mega}) {
+    Option<Unit> o = unit;
+    CHECK(o.unwrap() == unit);
+  }
+  Option<Option<Unit>> ou;
+  CHECK(ou.is_none());
+  ou.insert(Unit::Kilo);
+  CHECK(ou.unwrap() == Some(Unit::Kilo));
+
+  Option<Code> code = Code::Fail;
+  CHECK(code.map_or([](Code c) { return int(c); }, -1) == 2);
+
+  for (int i = 0; i < 256; ++i) {
+    Option<std::byte> ob = std::byte(i);
+    CHECK(ob.unwrap() == std::byte(i));
+    Option<char8_t> oc = char8_t(i);
+    CHECK(oc.unwrap() == char8_t(i));
+  }
+  CHECK(Option<std::byte>().is_none());
+  CHECK(Option<char8_t>().is_none());
+}
+
+// over-aligned payloads keep their size with a spare field, or with the tags in a side bitmap
+template <std::size_t Align>
+struct alignas(Align) OverAligned {
+  std::uint64_t data[Align / 8 - 1];
+  std::uint8_t spare = 0;
+};
+template <std::size_t Align>
+struct navp::niche_traits<OverAligned<Align>> : navp::spare_field<&OverAligned<Align>::spare> {};
+
+// counts live instances, the copy throws once copies_left runs out
+struct Fragile {
+  static inline int live = 0, copies_left = -1;
+  int id;
+  explicit Fragile(int id) : id(id) { ++live; }
+  Fragile(const Fragile& other) : id(other.id) {
+    if (copies_left == 0) throw std::runtime_error("copy");
+    --copies_left;
+    ++live;
+  }
+  Fragile(Fragile&& other) noexcept(false) : Fragile(static_cast<const Fragile&>(other)) {}
+  ~Fragile() { --live; }
+};
+
+TEST_CASE("Over Aligned") {
+  []<std::size_t... Shifts>(std::index_sequence<Shifts...>) {  // 16 .. 4096
+    static_assert(((sizeof(Option<OverAligned<(16u << Shifts)>>) == (16u << Shifts)) && ...));
+    static_assert(((sizeof(Option<OverAligned<(16u << Shifts)>, navp::Tagged>) == 2 * (16u << Shifts)) && ...));
+  }(std::make_index_sequence<9>{});
+  static_assert(sizeof(Option<Option<OverAligned<64>>>) == 64);
+
+  using Stats = OverAligned<64>;
+  Option<Stats> o;
+  CHECK(o.is_none());
+  o.insert(Stats{{1, 2, 3, 4, 5, 6, 7}});
+  CHECK(o.is_some());
+  CHECK(o.unwrap().data[6] == 7);
+  Option<Option<Stats>> oo{std::in_place, None};
+  CHECK(oo.is_some());
+  CHECK(oo.unwrap().is_none());
+  oo = None;
+  CHECK(oo.is_none());
+
+  navp::OptionColumn<Stats> column;
+  for (std::uint64_t i = 0; i < 200; ++i) {
+    if (i % 3 == 0) {
+      column.push_none();
+    } else {
+      column.emplace_back(Stats{{i}});
+    }
+  }
+  CHECK(column.size() == 200);
+  CHECK(column.count_some() == 133);
+  CHECK(column[0].is_none());
+  CHECK(column[1].unwrap().data[0] == 1);
+  CHECK(reinterpret_cast<std::uintptr_t>(&column[1].unwrap()) % 64 == 0);
+  column.reset(1);
+  CHECK(column.is_none(1));
+  column.replace(0, Stats{{42}});
+  auto copy = column;
+  CHECK(copy[0].unwrap().data[0] == 42);
+  CHECK(copy.count_some() == 133);
+  column.push_back(Option<Stats>(None));
+  column.push_back(Some(Stats{{9}}));
+  CHECK(column.size() == 202);
+  CHECK(column[201].unwrap().data[0] == 9);
+
+  navp::OptionColumn<std::string> strings;
+  strings.push_back(Some(std::string("Hello Option!")));
+  strings.push_none();
+  auto moved = std::move(strings);
+  CHECK(moved[0].unwrap() == "Hello Option!");
+  CHECK(moved[1].is_none());
+
+  // appending one of its own elements when the buffer is full, the copy is made before the old elements move
+  const std::string long_name(64, 'x');
+  navp::OptionColumn<std::string> names;
+  for (std::size_t i = 0; i < 8; ++i) {
+    names.emplace_back(long_name);
+  }
+  CHECK(names.capacity() == 8);
+  names.emplace_back(names[0].unwrap());
+  CHECK(names.capacity() == 16);
+  CHECK(names[8].unwrap() == long_name);
+  CHECK(names[0].unwrap() == long_name);
+  for (std::size_t i = 9; i < 16; ++i) {
+    names.push_none();
+  }
+  names.push_back(names[8]);
+  CHECK(names[16].unwrap() == long_name);
+
+  // a copy that throws part way unwinds the copies made so far, the source is untouched
+  {
+    navp::OptionColumn<Fragile> fragile;
+    for (int i = 0; i < 8; ++i) {
+      i % 4 == 1 ? fragile.push_none() : void(fragile.emplace_back(i));
+    }
+    CHECK(Fragile::live == 6);
+    Fragile::copies_left = 3;
+    CHECK_THROWS(navp::OptionColumn<Fragile>(fragile));
+    CHECK(Fragile::live == 6);
+    // the growth copies (the move may throw) and keeps the old payloads until every copy is made
+    Fragile::copies_left = 3;
+    CHECK_THROWS(fragile.emplace_back(8));
+    CHECK(Fragile::live == 6);
+    CHECK(fragile.size() == 8);
+    CHECK(fragile.capacity() == 8);
+    CHECK(fragile[7].unwrap().id == 7);
+    Fragile::copies_left = -1;
+  }
+  CHECK(Fragile::live == 0);
+}
+
+TEST_CASE("SentinelView") {
+  using navp::SentinelView;
+  // 150 values, every 7th is missing, crossing two block boundaries and ending in a partial block
+  std::vector<int> raw(150);
+  for (int i = 0; i < 150; ++i) {
+    raw[i] = i % 7 == 3 ? -1 : i;
+  }
+  SentinelView<int> view(raw);
+  CHECK(view.size() == 150);
+  CHECK(view[0].unwrap() == 0);
+  CHECK(&view[1].unwrap() == &raw[1]);
+  static_assert(sizeof(view[0]) == sizeof(const int*));
+  CHECK(view[3].is_none());
+  CHECK(view.get(4) == Some(4));
+  CHECK(view.get(10).is_none());
+  CHECK(view.count_some() == 150 - 21);
+  CHECK(view.find_first_none() == Some(std::size_t{3}));
+
+  std::size_t seen = 0;
+  for (auto o : view) {
+    seen += o.is_some();
+  }
+  CHECK(seen == view.count_some());
+
+  // a None only in the last, partial block
+  std::vector<std::uint16_t> ids(130, 7);
+  SentinelView<std::uint16_t, navp::is_sentinel<0xffff>> id_view(ids);
+  CHECK(id_view.count_some() == 130);
+  CHECK(id_view.find_first_none().is_none());
+  ids[129] = 0xffff;
+  CHECK(id_view.find_first_none() == Some(std::size_t{129}));
+  CHECK(SentinelView<int>().find_first_none().is_none());
+
+  std::vector<double> samples{1.0, std::numeric_limits<double>::quiet_NaN(), 3.0};
+  SentinelView<double, navp::is_nan> nan_view(samples);
+  CHECK(nan_view.count_some() == 2);
+  CHECK(nan_view.find_first_none() == Some(std::size_t{1}));
+
+  auto column = view.to_column();
+  CHECK(column.size() == 150);
+  CHECK(column.count_some() == view.count_some());
+  for (std::size_t i = 0; i < 150; ++i) {
+    CHECK(column.is_some(i) == view.is_some(i));
+  }
+  CHECK(column[149].unwrap() == 149);
+  column.push_back(Some(150));
+  CHECK(column.count_some() == view.count_some() + 1);
+
+  std::vector<std::string> names{"a", "", "c"};
+  CHECK(SentinelView<int>().to_column().empty());
+  auto strings = navp::OptionColumn<std::string>(std::span<const std::string>(names), {0b101});
+  CHECK(strings[0].unwrap() == "a");
+  CHECK(strings[1].is_none());
+  CHECK(strings[2].unwrap() == "c");
+  static_assert(std::is_same_v<decltype(strings[0]), Option<std::string&>>);
+  static_assert(std::is_same_v<decltype(std::as_const(strings)[0]), Option<const std::string&>>);
+}
+
 // from [https://github.com/TartanLlama/optional/tree/master/tests]
 TEST_CASE("Deletion") {
   static_assert(std::is_copy_constructible<Option<int>>::value);
@@ -145,6 +675,153 @@ TEST_CASE("Constexpr") {
   CHECK(!o6);
 }
 
+// the runtime tests again, evaluated by the compiler
+namespace constexpr_api {
+
+enum class Code : std::uint8_t { Ok, NotFound, Denied, max_value = Denied };
+
+constexpr bool watcher() {
+  auto f = [](const double& d) { return d > 0.0; };
+  Option<double> o1 = 1.0;
+  if (!o1.is_some_and(f) || !o1.is_none_or(f) || !o1) {
+    return false;
+  }
+  o1 = None;
+  if (o1.is_some_and(f) || !o1.is_none_or(f)) {
+    return false;
+  }
+
+  Option<std::vector<int>> o2 = std::vector<int>{1, 2, 3, 4, 5};
+  std::vector<int> fallback{1, 2, 3};
+  const auto& o2_ref = o2;
+  bool ok = o2.unwrap().size() == 5 && o2_ref.unwrap().size() == 5 && o2.expected("o2").size() == 5;
+  auto moved = std::move(o2).unwrap();
+  o2 = None;
+  ok = ok && moved.size() == 5 && o2.unwrap_or(fallback).size() == 3 && o2.unwrap_or_default().empty();
+  ok = ok && o2.unwrap_or_else([] { return std::vector<int>{1, 2}; }).size() == 2;
+  o2.insert(std::vector<int>{1, 2, 3, 4});
+  int seen = 0;
+  (void)o2.inspect([&](const std::vector<int>& v) { seen = static_cast<int>(v.size()); });
+  return ok && seen == 4 && o2.unwrap_unchecked().size() == 4;
+}
+
+constexpr bool replace_insert() {
+  Option<std::pair<int, int>> p;
+  auto& r = p.replace(0, 2);
+  if (r.first != 0 || r.second != 2) {
+    return false;
+  }
+  Option<std::vector<double>> v = None;
+  v.get_or_insert({1.0, 2.0, 3.0, 4.0});
+  v.get_or_insert({1.0});
+  bool ok = v.unwrap().size() == 4;
+  v.insert({2.0, 3.0});
+  return ok && v.unwrap().size() == 2;
+}
+
+constexpr bool map() {
+  Option<std::string> o1 = std::string("Hello Option!");
+  auto size = [](const std::string& str) { return str.size(); };
+  auto checked = [](const std::string& str) { return str.empty() ? Option<std::size_t>(None) : Some(str.size()); };
+  Option<std::string> none;
+  bool ok = o1.map(size) == Some(std::size_t{13}) && none.map(size).is_none();
+  ok = ok && o1.and_then(checked).unwrap() == 13 && none.and_then(checked).is_none();
+  ok = ok && none.map_or(size, std::size_t{9}) == 9 && o1.map_or(size, std::size_t{9}) == 13;
+  ok = ok && none.map_or_else([] { return std::size_t{10}; }, size) == 10;
+  auto upper = std::move(o1).map([](std::string&& s) {
+    for (auto& c : s) {
+      c = c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    return std::move(s);
+  });
+  return ok && upper.unwrap() == "HELLO OPTION!";
+}
+
+constexpr bool representations() {
+  using Int = Option<int, navp::Sentinel<std::numeric_limits<int>::min()>>;
+  Int s = None;
+  bool ok = s.unwrap_or(2) == 2;
+  s.insert(3);
+  ok = ok && s.map_or([](int i) { return i * 2; }, 0) == 6 && s.replace(5) == 5 && s == Some(5);
+  Option<Int> nested = s;
+  ok = ok && nested.flatten() == Some(5);
+
+  Option<double, navp::NanBoxed> d = None;
+  ok = ok && d.unwrap_or(2.0) == 2.0;
+  d.insert(3.0);
+  Option<double> tagged = d;
+  ok = ok && tagged == Some(3.0);
+
+  Option<Code> code = Code::Denied;
+  Option<Option<Code>> nested_code = code;
+  ok = ok && nested_code.unwrap() == code && code.map_or([](Code c) { return int(c); }, -1) == 2;
+
+  int x = 1;
+  Option<int*> ptr = &x;
+  ok = ok && *ptr.unwrap() == 1 && Option<int*>().is_none();
+  return ok && Option<bool>(false).unwrap() == false;
+}
+
+constexpr bool nested() {
+  using OO = Option<Option<int>>;
+  OO none;
+  OO some_none{std::in_place, None};
+  OO some_some{std::in_place, 42};
+  bool ok = none.is_none() && some_none.unwrap().is_none() && some_some.unwrap().unwrap() == 42;
+  OO copy = none;
+  copy = some_none;
+  ok = ok && copy.is_some();
+  copy = None;
+  copy.insert(7);
+  ok = ok && copy.unwrap() == Some(7) && some_none.flatten().is_none() && some_some.flatten() == Some(42);
+
+  Option<Option<std::string>> os{std::in_place, std::string("Hello Option!")};
+  auto os2 = os;
+  os2 = None;
+  ok = ok && os2.is_none();
+  os2 = os;
+  return ok && std::move(os2).flatten() == Some(std::string("Hello Option!"));
+}
+
+constexpr bool swap_and_ref() {
+  Option<std::string> o1(std::string("Hello World!"));
+  Option<std::string> o2(std::string("Goodbye Rust!"));
+  std::swap(o1, o2);
+  auto ref = o1.as_ref();
+  ref.unwrap().get() += "!";
+  return o1.unwrap() == "Goodbye Rust!!" && o2.unwrap() == "Hello World!";
+}
+
+// a lookup table of Options filled in by the compiler
+constexpr auto squares_of_evens = [] {
+  std::array<Option<int, navp::Sentinel<-1>>, 8> table{};
+  for (int i = 0; i < 8; i += 2) {
+    table[i] = i * i;
+  }
+  return table;
+}();
+
+}  // namespace constexpr_api
+
+TEST_CASE("Constexpr Api") {
+  static_assert(constexpr_api::watcher());
+  static_assert(constexpr_api::replace_insert());
+  static_assert(constexpr_api::map());
+  static_assert(constexpr_api::representations());
+  static_assert(constexpr_api::nested());
+  static_assert(constexpr_api::swap_and_ref());
+  static_assert(constexpr_api::squares_of_evens[6].unwrap() == 36 && constexpr_api::squares_of_evens[3].is_none());
+  static_assert(std::ranges::count_if(constexpr_api::squares_of_evens, [](auto o) { return o.is_some(); }) == 4);
+
+  // the same functions at run time
+  CHECK(constexpr_api::watcher());
+  CHECK(constexpr_api::replace_insert());
+  CHECK(constexpr_api::map());
+  CHECK(constexpr_api::representations());
+  CHECK(constexpr_api::nested());
+  CHECK(constexpr_api::swap_and_ref());
+}
+
 // from [https://github.com/TartanLlama/optional/tree/master/tests]
 TEST_CASE("Value Construct") {
   constexpr Option<int> o1 = 42;
@@ -239,6 +916,19 @@ TEST_CASE("Constructor") {
   v.emplace_back();
   Option<std::vector<foo>> ov = std::move(v);
   CHECK(ov.unwrap().size() == 1);
+
+  // a converting constructor is explicit exactly when the payload conversion is
+  struct Wrapper {
+    explicit Wrapper(int) {}
+  };
+  static_assert(std::is_convertible_v<int, Option<long>>);
+  static_assert(std::is_constructible_v<Option<Wrapper>, int> && !std::is_convertible_v<int, Option<Wrapper>>);
+  static_assert(std::is_convertible_v<Option<short>, Option<int>>);
+  static_assert(std::is_convertible_v<const Option<short, navp::Tagged>&, Option<int>>);
+  static_assert(std::is_constructible_v<Option<Wrapper>, Option<int>> &&
+                !std::is_convertible_v<Option<int>, Option<Wrapper>>);
+  static_assert(!std::is_constructible_v<Option<int>, std::string>);
+  static_assert(!std::is_constructible_v<Option<int>, Option<std::string>>);
 }
 
 // is_some(),is_none(),is_some_and(),is_none_or()
@@ -283,6 +973,33 @@ TEST_CASE("Watcher") {
   CHECK_THROWS(o5.expected("unwrap a none option"));
 }
 
+namespace {
+int unwrap_hook_calls = 0;
+std::string_view unwrap_hook_msg;
+}  // namespace
+
+TEST_CASE("Unwrap Hook") {
+  auto previous = navp::set_unwrap_hook([](const char* msg) {
+    ++unwrap_hook_calls;
+    unwrap_hook_msg = msg;
+  });
+  Option<int> o = None;
+  CHECK_THROWS_AS(o.unwrap(), navp::option_error);
+  CHECK(unwrap_hook_calls == 1);
+  CHECK_THROWS_WITH_AS(o.expected("no port configured"), "no port configured", navp::option_error);
+  CHECK(unwrap_hook_calls == 2);
+  CHECK(unwrap_hook_msg == "no port configured");
+  o = 8080;
+  CHECK(o.unwrap() == 8080);
+  CHECK(unwrap_hook_calls == 2);
+
+  // a throwing hook replaces option_error with its own exception
+  navp::set_unwrap_hook([](const char*) { throw std::runtime_error("hook"); });
+  o = None;
+  CHECK_THROWS_AS(std::move(o).unwrap(), std::runtime_error);
+  navp::set_unwrap_hook(previous);
+}
+
 // from [https://github.com/TartanLlama/optional/tree/master/tests]
 // replace()
 TEST_CASE("Replace") {
@@ -315,9 +1032,15 @@ TEST_CASE("Insert") {
 // map(),map_or(),map_or_default(),map_or_else()
 TEST_CASE("Map") {
   auto o1 = Some<std::string>("Hello Option!");
-  auto get_size1 = [](const std::string& str) { return Some(str.size()); };
+  auto get_size1 = [](const std::string& str) { return str.size(); };
   auto s1 = o1.map(get_size1);
+  static_assert(std::is_same_v<decltype(s1), Option<std::size_t>>);
   CHECK(s1.unwrap() == 13);
+  CHECK(Option<std::string>(None).map(get_size1).is_none());
+  auto checked_size = [](const std::string& str) { return str.empty() ? Option<std::size_t>(None) : Some(str.size()); };
+  CHECK(o1.and_then(checked_size).unwrap() == 13);
+  CHECK(Some<std::string>("").and_then(checked_size).is_none());
+  CHECK(o1.map(checked_size).unwrap() == Some(std::size_t{13}));
 
   Option<std::string> o2 = None;
   auto get_size2 = [](const std::string& str) {return str.size();};
@@ -335,6 +1058,198 @@ TEST_CASE("Map") {
   CHECK(s4 == 13);
 }
 
+template <typename O, typename F>
+concept can_map_in_place = requires(O o, F f) { o.map_in_place(f); };
+
+TEST_CASE("Map In Place") {
+  auto upper = [](std::string& str) {
+    for (auto& c : str) {
+      c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+  };
+  auto o1 = Some<std::string>("a string too long for the small buffer");
+  const char* buffer = o1.unwrap().data();
+  o1.map_in_place(upper).map_in_place([](std::string& str) { str.resize(8); });
+  CHECK(o1.unwrap() == "A STRING");
+  CHECK(o1.unwrap().data() == buffer);
+
+  Option<std::string> o2 = None;
+  CHECK(o2.map_in_place(upper).is_none());
+  static_assert(std::is_same_v<decltype(std::move(o2).map_in_place(upper)), Option<std::string>>);
+  auto copy = [](std::string& str) { return str; };
+  static_assert(!can_map_in_place<Option<std::string>&, decltype(copy)>, "only an f returning void");
+
+  // through an rvalue, map hands f the payload itself, so taking it by value keeps the buffer
+  auto o3 = Some<std::string>("another string too long for the small buffer");
+  buffer = o3.unwrap().data();
+  auto o4 = std::move(o3).map([](std::string str) {
+    str.erase(0, 8);
+    return str;
+  });
+  CHECK(o4.unwrap() == "string too long for the small buffer");
+  CHECK(o4.unwrap().data() == buffer);
+  auto o5 = std::move(o4).map_in_place([](std::string& str) { str.resize(6); });
+  CHECK(o5.unwrap() == "string");
+  CHECK(o5.unwrap().data() == buffer);
+
+  std::string s = "ref";
+  Option<std::string&> r = s;
+  r.map_in_place(upper);
+  CHECK(s == "REF");
+}
+
+// a 4 KiB buffer that can be neither copied nor moved, so it only ever exists where it was built
+struct Pinned {
+  explicit Pinned(char fill) : self(this) { bytes.fill(fill); }
+  Pinned(const Pinned&) = delete;
+  Pinned& operator=(const Pinned&) = delete;
+
+  std::array<char, 4096> bytes;
+  const Pinned* self;
+};
+
+TEST_CASE("From Fn") {
+  auto o1 = Option<Pinned>::from_fn([] { return Pinned('a'); });
+  CHECK(o1.unwrap().bytes[4095] == 'a');
+  CHECK(o1.unwrap().self == &o1.unwrap());
+
+  Option<Pinned> o2 = None;
+  int calls = 0;
+  auto make = [&] {
+    ++calls;
+    return Pinned(static_cast<char>('a' + calls));
+  };
+  auto& first = o2.get_or_insert_with(make);
+  CHECK(first.bytes[0] == 'b');
+  CHECK(first.self == &first);
+  CHECK(&o2.get_or_insert_with(make) == &first);
+  CHECK(calls == 1);
+  o2.insert_with(make);
+  CHECK(calls == 2);
+  CHECK(o2.unwrap().bytes[0] == 'c');
+  CHECK(o2.unwrap().self == &o2.unwrap());
+
+  // every representation, and a reference that never binds a temporary
+  static int target = 0;
+  CHECK(Option<int*>::from_fn([] { return &target; }) == Some(&target));
+  CHECK(Option<double, navp::NanBoxed>::from_fn([] { return 1.5; }) == Some(1.5));
+  Option<bool, navp::Packed> b = None;
+  CHECK(b.get_or_insert_with([] { return false; }) == false);
+  CHECK(b == Some(false));
+  int x = 0;
+  Option<int&> r = Option<int&>::from_fn([&]() -> int& { return x; });
+  CHECK(&r.unwrap() == &x);
+  int y = 1;
+  CHECK(&r.insert_with([&]() -> int& { return y; }).unwrap() == &y);
+  static_assert(!requires { Option<const int&>::from_fn([] { return 1; }); });
+
+  static_assert([] {
+    auto o = Option<std::vector<int>>::from_fn([] { return std::vector<int>{1, 2, 3}; });
+    return o.unwrap().size() == 3;
+  }());
+  static_assert([] {
+    Option<std::string> o = None;
+    o.get_or_insert_with([] { return std::string("built"); });
+    return o.unwrap() == "built";
+  }());
+}
+
+// a large record that is mostly absent
+struct Record {
+  std::array<std::uint64_t, 192> fields{};
+  std::string name;
+
+  bool operator==(const Record&) const = default;
+};
+
+TEST_CASE("Boxed") {
+  using navp::Boxed;
+  using Pool = navp::details::box_pool<sizeof(Record), alignof(Record)>;
+  static_assert(sizeof(Option<Record, Boxed>) == sizeof(void*));
+  static_assert(sizeof(Option<Option<int>, Boxed>) == sizeof(void*));
+  static_assert(std::is_nothrow_move_constructible_v<Option<Record, Boxed>>);
+  static_assert(Pool::block_size % alignof(Record) == 0 && Pool::block_size >= sizeof(Record));
+
+  Option<Record, Boxed> o1 = None;
+  CHECK(o1.is_none());
+  CHECK_THROWS(o1.unwrap());
+  auto& r = o1.get_or_insert(Record{{1, 2, 3}, "first"});
+  CHECK(o1.unwrap().fields[2] == 3);
+  CHECK(o1.map([](const Record& rec) { return rec.name; }) == Some<std::string>("first"));
+
+  // a copy gets a block of its own, a move hands the block over
+  auto o2 = o1;
+  CHECK(&o2.unwrap() != &r);
+  CHECK(o2.unwrap().name == "first");
+  auto o3 = std::move(o1);
+  CHECK(&o3.unwrap() == &r);
+  CHECK(o1.is_none());
+  o2 = o3;
+  CHECK(o2.unwrap().name == "first");
+  o3 = None;
+  CHECK(o3.is_none());
+
+  // the pool hands a freed block out again
+  o2.replace(Record{{7}, "second"});
+  CHECK(o2.unwrap().fields[0] == 7);
+  auto* block = &o2.unwrap();
+  o2 = None;
+  Option<Record, Boxed> o4(std::in_place, Record{{8}, "third"});
+  CHECK(&o4.unwrap() == block);
+  Option<Record> inline_copy = o4;
+  CHECK(inline_copy.unwrap().name == "third");
+  Option<Record, Boxed> boxed_copy = inline_copy;
+  CHECK(boxed_copy == o4);
+  std::swap(o4, o3);
+  CHECK(o4.is_none());
+  CHECK(o3.unwrap().name == "third");
+
+  auto pinned = Option<Pinned, Boxed>::from_fn([] { return Pinned('p'); });
+  CHECK(pinned.unwrap().self == &pinned.unwrap());
+  CHECK(pinned.unwrap().bytes[100] == 'p');
+
+  static_assert([] {
+    Option<std::vector<int>, Boxed> o(std::vector<int>{1, 2, 3});
+    auto copy = o;
+    o.unwrap().push_back(4);
+    return o.unwrap().size() == 4 && copy.unwrap().size() == 3;
+  }());
+
+  // blocks freed on another thread are reused there, and an exiting thread returns the blocks it kept
+  std::vector<Option<Record, Boxed>> records(64);
+  for (std::size_t i = 0; i < records.size(); i += 2) {
+    records[i].insert(Record{{i}, "record"});
+  }
+  auto shared = Pool::shared_blocks();
+  std::thread([&] {
+    std::size_t sum = 0;
+    for (auto& rec : records) {
+      sum += rec.map_or([](const Record& x) { return x.fields[0]; }, 0);
+      rec = None;
+    }
+    CHECK(sum == 31 * 32);
+    Option<Record, Boxed> local(Record{{1}, "local"});
+  }).join();
+  CHECK(std::ranges::all_of(records, [](const auto& rec) { return rec.is_none(); }));
+  CHECK(Pool::shared_blocks() == shared + 32);
+
+  // the same size as the payload, yet a Some is a pointer to it, so sequence must not copy the Options' bytes
+  static_assert(sizeof(Option<long, Boxed>) == sizeof(long));
+  static_assert(!navp::details::stores_payload_bytes<Option<long, Boxed>>);
+  static_assert(navp::details::stores_payload_bytes<Option<int*>>);
+  std::vector<Option<long, Boxed>> longs{1, 2, 3};
+  CHECK(navp::sequence(longs) == Some(std::vector<long>{1, 2, 3}));
+  int target = 0;
+  std::vector<Option<void*, Boxed>> pointers{&target, nullptr};
+  CHECK(navp::sequence(pointers) == Some(std::vector<void*>{&target, nullptr}));
+  CHECK(navp::traverse(longs, [](const Option<long, Boxed>& o) { return o; }) == Some(std::vector<long>{1, 2, 3}));
+  navp::ThreadPool pool(2);
+  std::vector<Option<long, Boxed>> many(1 << 16, Option<long, Boxed>(7));
+  auto all = navp::sequence(pool, many);
+  CHECK(all.unwrap().size() == many.size());
+  CHECK(std::ranges::all_of(all.unwrap(), [](long v) { return v == 7; }));
+}
+
 // todo
 // Member function testing
 // unwrap_or_else()
@@ -365,4 +1280,673 @@ TEST_CASE("Ref") {
   auto o1 = Some<std::string>("Hello C++23!");
   auto ref = o1.as_ref();
   static_assert(std::is_same_v<std::remove_cvref_t<decltype(ref.unwrap())>, std::reference_wrapper<std::string>>);
+
+  // Option<T&> is a pointer that reads None when null
+  static_assert(sizeof(Option<std::string&>) == sizeof(std::string*));
+  static_assert(std::is_trivially_copyable_v<Option<const int&>>);
+  static_assert(!std::is_constructible_v<Option<const int&>, int>, "never binds a temporary");
+  static_assert(!std::is_constructible_v<Option<const long&>, int&>, "nor one made by a conversion");
+  static_assert(std::is_same_v<decltype(Some(std::declval<int&>())), Option<int>>, "Some copies an lvalue");
+
+  std::string s = "Hello";
+  Option<std::string&> r = s;
+  r.unwrap() += " C++23!";
+  CHECK(s == "Hello C++23!");
+  static_assert(std::is_same_v<decltype(std::move(r).unwrap()), std::string&>);
+  CHECK(&std::move(r).unwrap() == &s);
+  CHECK(r.map([](const std::string& str) { return str.size(); }) == Some(std::size_t{12}));
+  std::string other = "other";
+  r = Option<std::string&>(other);
+  CHECK(&r.unwrap() == &other);
+  CHECK(s == "Hello C++23!");
+  Option<const std::string&> cr = r;
+  CHECK(cr.unwrap() == "other");
+  r = None;
+  CHECK(r.is_none());
+  CHECK(r.unwrap_or(s) == "Hello C++23!");
+  CHECK_THROWS(r.unwrap());
+  for (auto& str : Option<std::string&>(s)) {
+    CHECK(&str == &s);
+  }
+}
+
+TEST_CASE("Project") {
+  struct Counted {
+    int* copies;
+    std::string text;
+    Counted(int* c, std::string t) : copies(c), text(std::move(t)) {}
+    Counted(const Counted& other) : copies(other.copies), text(other.text) { ++*copies; }
+    Counted(Counted&&) noexcept = default;
+    Counted& operator=(const Counted&) = default;
+  };
+  struct Record {
+    int id;
+    Counted payload;
+    const Counted& get_payload() const { return payload; }
+  };
+  int copies = 0;
+  Option<Record> record(std::in_place, Record{7, Counted(&copies, std::string(64, 'x'))});
+  copies = 0;
+
+  auto payload = record.project(&Record::payload);
+  static_assert(std::is_same_v<decltype(payload), Option<Counted&>>);
+  CHECK(&payload.unwrap() == &record.unwrap().payload);
+  const auto& cref = record;
+  auto cpayload = cref.project(&Record::payload);
+  static_assert(std::is_same_v<decltype(cpayload), Option<const Counted&>>);
+  auto by_getter = cref.project([](const Record& r) -> const Counted& { return r.get_payload(); });
+  CHECK(&by_getter.unwrap() == &record.unwrap().payload);
+  CHECK(cref.project(&Record::id) == Some(7));
+  record.project(&Record::id).unwrap() = 8;
+  CHECK(record.unwrap().id == 8);
+  CHECK(copies == 0);
+
+  // the rvalue overload moves the member out and leaves the rest of the record
+  auto moved = std::move(record).project(&Record::payload);
+  static_assert(std::is_same_v<decltype(moved), Option<Counted>>);
+  CHECK(copies == 0);
+  CHECK(moved.unwrap().text.size() == 64);
+  CHECK(record.unwrap().id == 8);
+  CHECK(record.unwrap().payload.text.empty());
+
+  Option<Record> none;
+  CHECK(none.project(&Record::payload).is_none());
+  CHECK(std::move(none).project(&Record::payload).is_none());
+
+  // through an Option<T&> the projection stays a reference, rvalue or not
+  Record target{1, Counted(&copies, "target")};
+  Option<Record&> ref = target;
+  auto text = std::move(ref).project(&Record::payload);
+  static_assert(std::is_same_v<decltype(text), Option<Counted&>>);
+  CHECK(&text.unwrap() == &target.payload);
+  CHECK(copies == 0);
+}
+
+TEST_CASE("Lookup") {
+  // one probe per get, counted through the hash, with a string_view key and no std::string built for it
+  struct counting_hash {
+    using is_transparent = void;
+    int* calls;
+    std::size_t operator()(std::string_view s) const noexcept {
+      ++*calls;
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+  int calls = 0;
+  std::unordered_map<std::string, int, counting_hash, std::equal_to<>> ports(8, counting_hash{&calls});
+  ports.emplace("http", 80);
+  ports.emplace("https", 443);
+  calls = 0;
+  auto https = navp::get(ports, std::string_view("https"));
+  static_assert(std::is_same_v<decltype(https), Option<int&>>);
+  CHECK(calls == 1);
+  REQUIRE(https.is_some());
+  https.unwrap() = 8443;
+  CHECK(ports.at("https") == 8443);
+  CHECK(navp::get(ports, std::string_view("gopher")).is_none());
+
+  const std::map<std::string, int, std::less<>> sorted{{"a", 1}, {"b", 2}};
+  auto b = navp::get(sorted, std::string_view("b"));
+  static_assert(std::is_same_v<decltype(b), Option<const int&>>);
+  CHECK(&b.unwrap() == &sorted.at("b"));
+  CHECK(navp::get(sorted, "c").is_none());
+  std::set<int> ids{3, 5};
+  CHECK(navp::get(ids, 5) == Some(5));
+  CHECK(navp::get(ids, 4).is_none());
+
+  std::vector<std::string> names{"x", "y"};
+  CHECK(&navp::get(names, 1).unwrap() == &names[1]);
+  CHECK(navp::get(names, 2).is_none());
+  int raw[3] = {7, 8, 9};
+  CHECK(navp::get(raw, 2) == Some(9));
+  CHECK(navp::get(std::as_const(names), 0).unwrap() == "x");
+  static_assert(std::is_same_v<decltype(navp::get(std::as_const(names), 0)), Option<const std::string&>>);
+
+  CHECK(&navp::front(names).unwrap() == &names.front());
+  CHECK(&navp::back(names).unwrap() == &names.back());
+  std::list<int> empty;
+  CHECK(navp::front(empty).is_none());
+  CHECK(navp::back(empty).is_none());
+
+  // try_pop moves the element out, one call per element
+  std::queue<std::unique_ptr<int>> fifo;
+  fifo.push(std::make_unique<int>(1));
+  fifo.push(std::make_unique<int>(2));
+  CHECK(*navp::try_pop(fifo).unwrap() == 1);
+  CHECK(*navp::try_pop(fifo).unwrap() == 2);
+  CHECK(navp::try_pop(fifo).is_none());
+  std::stack<std::string> lifo;
+  lifo.push("bottom");
+  lifo.push("top");
+  CHECK(navp::try_pop(lifo) == Some(std::string("top")));
+  CHECK(lifo.size() == 1);
+  std::priority_queue<int> heap;
+  for (int i : {4, 9, 1}) {
+    heap.push(i);
+  }
+  CHECK(navp::try_pop(heap) == Some(9));
+  CHECK(navp::try_pop(heap) == Some(4));
+}
+
+// at namespace scope, gcc's -fsanitize=null does not fold the address of a block-scope static in constant evaluation
+namespace static_map_tables {
+
+constexpr auto ports = navp::make_static_map<std::string_view, int>(
+    {{"http", 80}, {"https", 443}, {"ssh", 22}, {"smtp", 25}, {"dns", 53}});
+
+// every even key up to 6000 maps to its square
+constexpr auto squares = [] {
+  std::array<std::pair<std::uint32_t, std::uint64_t>, 3000> entries{};
+  for (std::uint32_t i = 0; i < entries.size(); ++i) {
+    entries[i] = {i * 2, std::uint64_t(i) * i};
+  }
+  return navp::make_static_map(entries);
+}();
+
+}  // namespace static_map_tables
+
+TEST_CASE("StaticMap") {
+  using navp::make_static_map;
+  using static_map_tables::ports;
+  using static_map_tables::squares;
+  static_assert(ports.size() == 5);
+  static_assert(ports.find("https").unwrap() == 443);
+  static_assert(ports.find("gopher").is_none() && ports.find("").is_none());
+  static_assert(std::is_same_v<decltype(ports.find("ssh")), Option<const int&>>);
+
+  std::string key = "smtp";
+  REQUIRE(ports.find(key).is_some());
+  CHECK(&ports.find(key).unwrap() == &std::next(ports.begin(), 3)->second);
+  CHECK(ports.contains("dns"));
+  CHECK(!ports.contains("dns "));
+  int seen = 0;
+  for (const auto& [name, port] : ports) {
+    CHECK(ports.find(name) == Some(port));
+    ++seen;
+  }
+  CHECK(seen == 5);
+
+  // a large table, every key found and a miss next to every key
+  static_assert(squares.find(2 * 1234).unwrap() == 1234u * 1234u);
+  int found = 0;
+  for (std::uint32_t i = 0; i < 3000; ++i) {
+    found += squares.find(i * 2) == Some(std::uint64_t(i) * i);
+    found -= squares.find(i * 2 + 1).is_some();
+  }
+  CHECK(found == 3000);
+
+  enum class Level : std::uint8_t { Debug, Info, Warn };
+  constexpr auto names = make_static_map<Level, std::string_view>({{Level::Warn, "warn"}, {Level::Debug, "debug"}});
+  static_assert(names.find(Level::Warn).unwrap() == "warn" && names.find(Level::Info).is_none());
+
+  // the same construction at run time reports duplicates with an exception
+  std::array<std::pair<int, int>, 3> duplicated{{{1, 1}, {2, 2}, {1, 3}}};
+  CHECK_THROWS_AS(make_static_map(duplicated), std::invalid_argument);
+}
+
+// MpmcQueue
+TEST_CASE("MpmcQueue") {
+  struct NoDefault {
+    explicit NoDefault(int v) : v(v) {}
+    int v;
+  };
+
+  navp::MpmcQueue<NoDefault> q(3);
+  CHECK(q.capacity() == 4);
+  CHECK(q.try_pop().is_none());
+  for (int i = 0; i < 4; ++i) {
+    CHECK(q.try_emplace(i));
+  }
+  CHECK(!q.try_emplace(4));
+  for (int i = 0; i < 4; ++i) {
+    auto o = q.try_pop();
+    REQUIRE(o.is_some());
+    CHECK(o.unwrap().v == i);
+  }
+  CHECK(q.try_pop().is_none());
+
+  navp::MpmcQueue<std::string> sq(2);
+  CHECK(sq.try_push(std::string("Hello Option!")));
+  CHECK(sq.try_pop() == Some(std::string("Hello Option!")));
+
+  // a pushed null pointer comes back as Some(null), not as an empty queue
+  navp::MpmcQueue<int*> pq(2);
+  CHECK(pq.try_push(nullptr));
+  auto null_elem = pq.try_pop();
+  static_assert(std::is_same_v<decltype(null_elem), Option<int*, navp::Tagged>>);
+  CHECK(null_elem.is_some());
+  CHECK(null_elem.unwrap() == nullptr);
+  CHECK(pq.try_pop().is_none());
+
+  constexpr int producers = 4, consumers = 4, per_producer = 10000;
+  navp::MpmcQueue<int> mq(64);
+  std::atomic<long> sum{0};
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      for (int i = 1; i <= per_producer; ++i) {
+        while (!mq.try_push(i)) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      while (popped.load() < producers * per_producer) {
+        if (auto o = mq.try_pop()) {
+          sum += o.unwrap();
+          ++popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  CHECK(sum.load() == long(producers) * per_producer * (per_producer + 1) / 2);
+}
+
+// WorkStealingDeque
+TEST_CASE("WorkStealingDeque") {
+  navp::WorkStealingDeque<int> d(2);
+  CHECK(d.pop().is_none());
+  CHECK(d.steal().is_none());
+  for (int i = 0; i < 10; ++i) {
+    d.push(i);
+  }
+  CHECK(d.size() == 10);
+  CHECK(d.steal() == Some(0));
+  CHECK(d.pop() == Some(9));
+  CHECK(d.steal() == Some(1));
+  CHECK(d.pop() == Some(8));
+
+  // null pointers are elements, both ends hand them back as Some(null)
+  navp::WorkStealingDeque<int*> pd;
+  pd.push(nullptr);
+  pd.push(nullptr);
+  CHECK(pd.steal().is_some_and([](int* p) { return p == nullptr; }));
+  CHECK(pd.pop().is_some_and([](int* p) { return p == nullptr; }));
+  CHECK(pd.pop().is_none());
+
+  constexpr int items = 100000;
+  navp::WorkStealingDeque<int> wd;
+  std::atomic<long> stolen{0};
+  std::atomic<bool> done{false};
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.emplace_back([&] {
+      while (!done.load() || !wd.empty()) {
+        if (auto o = wd.steal()) {
+          stolen += o.unwrap();
+        }
+      }
+    });
+  }
+  long owned = 0;
+  for (int i = 1; i <= items; ++i) {
+    wd.push(i);
+    if (i % 3 == 0) {
+      if (auto o = wd.pop()) {
+        owned += o.unwrap();
+      }
+    }
+  }
+  while (auto o = wd.pop()) {
+    owned += o.unwrap();
+  }
+  done = true;
+  for (auto& t : thieves) t.join();
+  CHECK(owned + stolen.load() == long(items) * (items + 1) / 2);
+}
+
+// ThreadPool, TaskGroup
+TEST_CASE("ThreadPool") {
+  navp::ThreadPool pool(4);
+  CHECK(pool.size() == 4);
+
+  std::atomic<int> count{0};
+  {
+    navp::TaskGroup group(pool);
+    for (int i = 0; i < 1000; ++i) {
+      group.run([&] { ++count; });
+    }
+    group.wait();
+  }
+  CHECK(count.load() == 1000);
+
+  auto fib = [&](auto& self, int n) -> long {
+    if (n < 2) return n;
+    long a = 0, b = 0;
+    navp::TaskGroup group(pool);
+    group.run([&] { a = self(self, n - 1); });
+    b = self(self, n - 2);
+    group.wait();
+    return a + b;
+  };
+  CHECK(fib(fib, 20) == 6765);
+
+  navp::TaskGroup group(pool);
+  group.run([] { throw std::runtime_error("task failed"); });
+  CHECK_THROWS_AS(group.wait(), std::runtime_error);
+}
+
+// OptionCache
+TEST_CASE("OptionCache") {
+  navp::OptionCache<int, std::string> cache(4, 1);
+  CHECK(cache.get(1).is_none());
+
+  int calls = 0;
+  auto lookup = [&](const int& key) -> Option<std::string> {
+    ++calls;
+    if (key % 2 == 0) return Some(std::to_string(key));
+    return None;
+  };
+  CHECK(cache.get_or_compute(2, lookup) == Some(std::string("2")));
+  CHECK(cache.get_or_compute(3, lookup).is_none());
+  CHECK(cache.get_or_compute(2, lookup) == Some(std::string("2")));
+  CHECK(cache.get_or_compute(3, lookup).is_none());
+  CHECK(calls == 2);
+  CHECK(cache.get(3).is_some());
+  CHECK(cache.get(3).unwrap().is_none());
+
+  // a pointer answer keeps its null niche: null is the negative answer, a hit, not a miss
+  navp::OptionCache<int, const int*> pcache(2, 1);
+  static int target = 7;
+  pcache.put(1, &target);
+  pcache.put(2, None);
+  CHECK(pcache.get(1) == Some(Option<const int*>(&target)));
+  CHECK(pcache.get(2).is_some());
+  CHECK(pcache.get(2).unwrap().is_none());
+  CHECK(pcache.get(3).is_none());
+
+  // capacity 4, the clock spares 2 and 3 because they were read since insertion
+  cache.put(4, Some(std::string("4")));
+  cache.put(5, None);
+  cache.put(6, Some(std::string("6")));
+  CHECK(cache.size() == 4);
+  CHECK(cache.get(2).is_some());
+  CHECK(cache.get(3).is_some());
+  CHECK(cache.get(4).is_none());
+  CHECK(cache.erase(3));
+  CHECK(!cache.erase(3));
+  cache.clear();
+  CHECK(cache.size() == 0);
+
+  // an insert that throws while indexing the new key keeps the entry it would have evicted
+  struct PickyKey {
+    int id;
+    PickyKey(int id) : id(id) {}
+    PickyKey(const PickyKey& other) : id(other.id) {
+      if (id < 0) throw std::runtime_error("uncopyable");
+    }
+    bool operator==(const PickyKey&) const = default;
+  };
+  struct PickyHash {
+    std::size_t operator()(const PickyKey& key) const noexcept { return std::hash<int>{}(key.id); }
+  };
+  navp::OptionCache<PickyKey, int, PickyHash> picky(1, 1);
+  picky.put(1, Some(10));
+  CHECK_THROWS(picky.put(-1, Some(20)));
+  CHECK(picky.size() == 1);
+  CHECK(picky.get(1) == Some(Option<int>(10)));
+  picky.put(2, Some(30));
+  CHECK(picky.get(1).is_none());
+  CHECK(picky.get(2) == Some(Option<int>(30)));
+
+  // concurrent misses on one key compute once
+  navp::OptionCache<int, int> shared(64);
+  std::atomic<int> computed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&] {
+      for (int key = 0; key < 16; ++key) {
+        auto o = shared.get_or_compute(key, [&](const int& k) -> Option<int> {
+          ++computed;
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          return k % 3 == 0 ? None : Option<int>(k);
+        });
+        CHECK(o.is_some() == (key % 3 != 0));
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  CHECK(computed.load() == 16);
+
+  CHECK_THROWS(shared.get_or_compute(100, [](const int&) -> Option<int> { throw std::runtime_error("backend"); }));
+  CHECK(shared.get(100).is_none());
+}
+
+namespace coroutine_test {
+int frames = 0;
+struct Frame {
+  Frame() { ++frames; }
+  ~Frame() { --frames; }
+};
+
+Option<int> lookup(const std::map<std::string, int>& m, const std::string& key) {
+  auto it = m.find(key);
+  return it == m.end() ? Option<int>(None) : Option<int>(it->second);
+}
+
+Option<int> sum(const std::map<std::string, int>& m) {
+  Frame frame;
+  int a = co_await lookup(m, "a");
+  int b = co_await lookup(m, "b");
+  co_return a + b;
+}
+
+Option<int> twice(std::allocator_arg_t, std::pmr::polymorphic_allocator<>, const std::map<std::string, int>& m) {
+  co_return co_await lookup(m, "a") * 2;
+}
+
+Option<std::unique_ptr<int>> take(Option<std::unique_ptr<int>>& slot) {
+  auto& owned = co_await slot;
+  co_return std::move(owned);
+}
+
+Option<int> checked(Option<int> o) {
+  int val = co_await o;
+  if (val < 0) {
+    throw std::runtime_error("negative");
+  }
+  co_return None;
+}
+}  // namespace coroutine_test
+
+TEST_CASE("Coroutine") {
+  using namespace coroutine_test;
+  std::map<std::string, int> m{{"a", 1}, {"b", 2}};
+  CHECK(sum(m) == Some(3));
+  CHECK(frames == 0);
+  m.erase("b");
+  CHECK(sum(m).is_none());
+  CHECK(frames == 0);
+
+  // the frame comes from the arena, which refuses to fall back to the heap
+  unsigned char buffer[1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof buffer, std::pmr::null_memory_resource());
+  CHECK(twice(std::allocator_arg, &arena, m) == Some(2));
+  m.clear();
+  CHECK(twice(std::allocator_arg, &arena, m).is_none());
+
+  Option<std::unique_ptr<int>> slot = std::make_unique<int>(7);
+  auto taken = take(slot);
+  CHECK(*taken.unwrap() == 7);
+  CHECK(slot.is_none());
+  CHECK(take(slot).is_none());
+
+  CHECK(checked(Some(1)).is_none());
+  CHECK(checked(None).is_none());
+  CHECK_THROWS_AS(checked(Some(-1)), std::runtime_error);
+}
+
+TEST_CASE("Ranges") {
+  using namespace navp;
+  Option<int> one = 4;
+  static_assert(std::ranges::contiguous_range<Option<int>>);
+  static_assert(std::ranges::sized_range<const Option<std::string>>);
+  CHECK(std::ranges::size(one) == 1);
+  CHECK(std::ranges::distance(Option<int>()) == 0);
+  for (int& x : one) {
+    x += 1;
+  }
+  CHECK(one == Some(5));
+
+  std::vector<Option<int>> column{1, None, 3, None, 5};
+  std::vector<int> somes;
+  for (int& x : column | views::somes) {
+    somes.push_back(x);
+  }
+  CHECK(somes == std::vector<int>{1, 3, 5});
+  static_assert(std::ranges::forward_range<decltype(column | views::somes)>);
+  std::vector<int> prefix;
+  for (int x : views::take_while_some(column)) {
+    prefix.push_back(x);
+  }
+  CHECK(prefix == std::vector<int>{1});
+
+  // a stream of computed Options is read once per element
+  int calls = 0;
+  auto stream = std::views::iota(0, 10) | std::views::transform([&](int i) {
+                  ++calls;
+                  using Owned = Option<std::unique_ptr<int>>;
+                  return i % 3 == 2 ? Owned(None) : Owned(std::make_unique<int>(i));
+                });
+  std::vector<int> streamed;
+  for (auto& p : stream | views::somes) {
+    streamed.push_back(*p);
+  }
+  CHECK(streamed == std::vector<int>{0, 1, 3, 4, 6, 7, 9});
+  CHECK(calls == 10);
+  calls = 0;
+  std::size_t taken = 0;
+  for (auto& p : stream | views::take_while_some) {
+    taken += p != nullptr;
+  }
+  CHECK(taken == 2);
+  CHECK(calls == 3);
+
+  CHECK(collect_option(column).is_none());
+  column[1] = 2;
+  column[3] = 4;
+  CHECK(collect_option(column) == Some(std::vector<int>{1, 2, 3, 4, 5}));
+  CHECK(column[0] == Some(1));
+
+  std::vector<Option<std::unique_ptr<int>>> owners;
+  owners.emplace_back(std::make_unique<int>(7));
+  auto collected = collect_option(std::move(owners));
+  CHECK(*collected.unwrap()[0] == 7);
+  CHECK(collect_option(stream).is_none());
+  CHECK(collect_option(std::views::iota(0, 3) | std::views::transform([](int i) { return Option<int>(i); })).unwrap().size() ==
+        3);
+}
+
+TEST_CASE("Sequence") {
+  using namespace navp;
+  std::vector<Option<int>> tagged{1, 2, 3};
+  CHECK(sequence(tagged) == Some(std::vector<int>{1, 2, 3}));
+  std::vector<Option<int, Sentinel<-1>>> packed{4, 5, None};
+  CHECK(sequence(packed).is_none());
+  packed.back() = 6;
+  CHECK(sequence(packed) == Some(std::vector<int>{4, 5, 6}));
+  CHECK(sequence(std::vector<Option<int>>{}) == Some(std::vector<int>{}));
+
+  std::vector<Option<std::string>> names{"a", "b"};
+  CHECK(sequence(names) == Some(std::vector<std::string>{"a", "b"}));
+  CHECK(names[0] == Some(std::string("a")));
+  CHECK(sequence(std::move(names)).unwrap()[1] == "b");
+  std::list<Option<int>> linked{7, 8};
+  CHECK(sequence(linked) == Some(std::vector<int>{7, 8}));
+
+  auto parse = [](char c) { return c >= '0' && c <= '9' ? Option<int>(c - '0') : Option<int>(None); };
+  std::string digits = "0123";
+  CHECK(traverse(digits, parse) == Some(std::vector<int>{0, 1, 2, 3}));
+  int calls = 0;
+  CHECK(traverse(std::string("1x23"), [&](char c) { return ++calls, parse(c); }).is_none());
+  CHECK(calls == 2);
+
+  ThreadPool pool(4);
+  constexpr int rows = 1 << 18;
+  std::vector<Option<int>> column(rows);
+  std::vector<Option<int, Sentinel<-1>>> packed_column(rows);
+  for (int i = 0; i < rows; ++i) {
+    column[i] = i;
+    packed_column[i] = i;
+  }
+  auto all = sequence(pool, column);
+  REQUIRE(all.is_some());
+  CHECK(all.unwrap().size() == rows);
+  CHECK(all.unwrap()[rows - 1] == rows - 1);
+  CHECK(sequence(pool, packed_column).unwrap() == all.unwrap());
+  for (int at : {0, rows / 2, rows - 1}) {
+    auto saved = column[at];
+    column[at] = None;
+    CHECK(sequence(pool, column).is_none());
+    column[at] = saved;
+  }
+
+  std::vector<Option<std::unique_ptr<int>>> owners;
+  for (int i = 0; i < rows; ++i) {
+    owners.emplace_back(std::make_unique<int>(i));
+  }
+  auto moved = sequence(pool, std::move(owners));
+  CHECK(*moved.unwrap()[rows / 2] == rows / 2);
+
+  std::vector<int> ids(rows);
+  std::iota(ids.begin(), ids.end(), 0);
+  auto halve = [](int i) { return i % 2 == 0 ? Option<int>(i / 2) : Option<int>(None); };
+  CHECK(traverse(pool, ids, [](int i) { return Option<long>(i * 2L); }).unwrap()[rows - 1] == 2L * (rows - 1));
+  CHECK(traverse(pool, ids, halve).is_none());
+  std::atomic<int> evaluated{0};
+  CHECK(traverse(pool, ids, [&](int i) {
+          ++evaluated;
+          return i == 0 ? Option<int>(None) : Option<int>(i);
+        }).is_none());
+  CHECK(evaluated.load() < rows);
+  // a reference_wrapper cannot be presized, so this one runs serially
+  auto refs = traverse(pool, ids, [&](int i) { return Option<std::reference_wrapper<const int>>(std::cref(ids[i])); });
+  CHECK(&refs.unwrap()[rows - 1].get() == &ids[rows - 1]);
+}
+
+TEST_CASE("Parallel Short Circuit") {
+  using namespace navp;
+  ThreadPool pool(4);
+  auto all = all_some_parallel(
+      pool, [] { return Option<int>(1); }, [] { return Option<std::string>("two"); },
+      [](std::stop_token) { return Option<double>(3.0); });
+  REQUIRE(all.is_some());
+  CHECK(std::get<0>(all.unwrap()) == 1);
+  CHECK(std::get<1>(all.unwrap()) == "two");
+  CHECK(std::get<2>(all.unwrap()) == 3.0);
+
+  // the caller runs the first task, which polls until the None from the second one stops it
+  std::atomic<bool> gave_up{false};
+  auto none = all_some_parallel(
+      pool,
+      [&](std::stop_token stop) {
+        while (!stop.stop_requested()) {
+          std::this_thread::yield();
+        }
+        gave_up = true;
+        return Option<int>(None);
+      },
+      [] { return Option<int>(None); });
+  CHECK(none.is_none());
+  CHECK(gave_up.load());
+  CHECK_THROWS_AS(all_some_parallel(
+                      pool, [] { return Option<int>(1); },
+                      []() -> Option<int> { throw std::runtime_error("task failed"); }),
+                  std::runtime_error);
+
+  std::vector<int> ids(1000);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::atomic<int> calls{0};
+  auto hit = first_some_parallel(pool, ids, [&](int i) {
+    ++calls;
+    return i % 100 == 37 ? Option<int>(i) : Option<int>(None);
+  });
+  CHECK(hit == Some(37));
+  CHECK(calls.load() < 1000);
+  CHECK(first_some_parallel(pool, ids, [](int) { return Option<int>(None); }).is_none());
+  CHECK(first_some_parallel(pool, std::vector<int>{}, [](int i) { return Option<int>(i); }).is_none());
 }
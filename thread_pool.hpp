@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrency.hpp"
+#include "mpmc_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace navp {
+
+namespace details {
+
+// type-erased heap task, run() also frees it
+struct PoolTask {
+  void (*run)(PoolTask*);
+};
+
+template <typename F>
+struct PoolTaskImpl final : PoolTask {
+  template <typename G>
+  explicit PoolTaskImpl(G&& g) : PoolTask{&invoke}, f(std::forward<G>(g)) {}
+
+  static void invoke(PoolTask* task) {
+    std::unique_ptr<PoolTaskImpl> self(static_cast<PoolTaskImpl*>(task));
+    self->f();
+  }
+
+  F f;
+};
+
+}  // namespace details
+
+// work-stealing thread pool, each worker owns a WorkStealingDeque and steals from the others when it runs dry
+// tasks spawned from outside the pool go through a shared MpmcQueue
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+    threads = threads == 0 ? 1 : threads;
+    _m_workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+      _m_workers.push_back(std::make_unique<_Worker>(this));
+    }
+    for (auto& worker : _m_workers) {
+      worker->thread = std::thread([this, w = worker.get()] { _m_worker_loop(w); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // runs every spawned task to completion, then joins
+  ~ThreadPool() {
+    _m_stop.store(true, std::memory_order_seq_cst);
+    _m_epoch.fetch_add(1, std::memory_order_release);
+    _m_epoch.notify_all();
+    for (auto& worker : _m_workers) {
+      worker->thread.join();
+    }
+  }
+
+  std::size_t size() const noexcept { return _m_workers.size(); }
+
+  // steals performed by the workers so far
+  std::uint64_t steal_count() const noexcept {
+    std::uint64_t count = 0;
+    for (auto& worker : _m_workers) {
+      count += worker->steals.load(std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  // spawn, fire and forget; an exception escaping f terminates the program, use TaskGroup to propagate it
+  template <typename F>
+  void spawn(F&& f) {
+    auto* task = new details::PoolTaskImpl<std::decay_t<F>>(std::forward<F>(f));
+    _m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (auto* self = _m_current(); self != nullptr && self->pool == this) {
+      self->deque.push(task);
+    } else {
+      while (!_m_injector.try_push(task)) {
+        if (!_m_run_one()) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    _m_wake();
+  }
+
+ private:
+  friend class TaskGroup;
+
+  struct alignas(details::cache_line_size) _Worker {
+    explicit _Worker(ThreadPool* pool) : pool(pool) {}
+
+    ThreadPool* pool;
+    WorkStealingDeque<details::PoolTask*> deque;
+    std::atomic<std::uint64_t> steals{0};
+    std::thread thread;
+  };
+
+  static _Worker*& _m_current() noexcept {
+    thread_local _Worker* current = nullptr;
+    return current;
+  }
+
+  static std::uint32_t _m_random() noexcept {
+    thread_local std::uint32_t state = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state)) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  details::element_option_t<details::PoolTask*> _m_find_task(_Worker* self) noexcept {
+    if (self != nullptr) {
+      if (auto task = self->deque.pop()) {
+        return task;
+      }
+    }
+    if (auto task = _m_injector.try_pop()) {
+      return task;
+    }
+    auto n = _m_workers.size();
+    auto start = _m_random() % n;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto* victim = _m_workers[(start + i) % n].get();
+      if (victim == self) {
+        continue;
+      }
+      if (auto task = victim->deque.steal()) {
+        if (self != nullptr) {
+          self->steals.fetch_add(1, std::memory_order_relaxed);
+        }
+        return task;
+      }
+    }
+    return None;
+  }
+
+  void _m_execute(details::PoolTask* task) {
+    task->run(task);
+    _m_pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  // find and run one task from any thread, used by waiters to help instead of blocking
+  bool _m_run_one() {
+    auto* self = _m_current();
+    if (auto task = _m_find_task(self != nullptr && self->pool == this ? self : nullptr)) {
+      _m_execute(task.unwrap_unchecked());
+      return true;
+    }
+    return false;
+  }
+
+  void _m_wake() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_m_sleepers.load(std::memory_order_relaxed) != 0) {
+      _m_epoch.fetch_add(1, std::memory_order_release);
+      _m_epoch.notify_one();
+    }
+  }
+
+  void _m_sleep(_Worker* self) {
+    auto epoch = _m_epoch.load(std::memory_order_acquire);
+    _m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    if (auto task = _m_find_task(self)) {
+      _m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+      _m_execute(task.unwrap_unchecked());
+      return;
+    }
+    if (!_m_stop.load(std::memory_order_seq_cst)) {
+      _m_epoch.wait(epoch, std::memory_order_acquire);
+    }
+    _m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void _m_worker_loop(_Worker* self) {
+    _m_current() = self;
+    unsigned idle = 0;
+    for (;;) {
+      if (auto task = _m_find_task(self)) {
+        _m_execute(task.unwrap_unchecked());
+        idle = 0;
+      } else if (_m_stop.load(std::memory_order_acquire)) {
+        if (_m_pending.load(std::memory_order_acquire) == 0) {
+          break;
+        }
+        std::this_thread::yield();
+      } else if (++idle < 64) {
+        details::cpu_relax();
+      } else if (idle < 128) {
+        std::this_thread::yield();
+      } else {
+        _m_sleep(self);
+        idle = 0;
+      }
+    }
+    _m_current() = nullptr;
+  }
+
+  std::vector<std::unique_ptr<_Worker>> _m_workers;
+  MpmcQueue<details::PoolTask*> _m_injector{4096};
+  alignas(details::cache_line_size) std::atomic<std::size_t> _m_pending{0};
+  alignas(details::cache_line_size) std::atomic<std::uint32_t> _m_epoch{0};
+  std::atomic<std::uint32_t> _m_sleepers{0};
+  std::atomic<bool> _m_stop{false};
+};
+
+// fork-join scope over a ThreadPool, wait() runs pending tasks instead of blocking
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool) noexcept : _m_pool(pool) {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  ~TaskGroup() { _m_join(); }
+
+  template <typename F>
+  void run(F&& f) {
+    _m_pending.fetch_add(1, std::memory_order_relaxed);
+    _m_pool.spawn([this, f = std::forward<F>(f)]() mutable {
+      try {
+        f();
+      } catch (...) {
+        if (!_m_failed.test_and_set(std::memory_order_relaxed)) {
+          _m_error = std::current_exception();
+        }
+      }
+      _m_pending.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  // wait, rethrows the first exception thrown by a task of this group
+  void wait() {
+    _m_join();
+    if (_m_error) {
+      _m_failed.clear(std::memory_order_relaxed);
+      std::rethrow_exception(std::exchange(_m_error, nullptr));
+    }
+  }
+
+ private:
+  void _m_join() {
+    while (_m_pending.load(std::memory_order_acquire) != 0) {
+      if (!_m_pool._m_run_one()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  ThreadPool& _m_pool;
+  std::atomic<std::size_t> _m_pending{0};
+  std::atomic_flag _m_failed;
+  std::exception_ptr _m_error;
+};
+
+}  // namespace navp
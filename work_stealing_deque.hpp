@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "concurrency.hpp"
+#include "option.hpp"
+
+namespace navp {
+
+// chase-lev work-stealing deque, memory orders follow le et al. (ppopp 2013)
+// the owner thread calls push/pop on the bottom, any thread may steal from the top
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>, "thieves read slots racily, T must be trivially copyable");
+
+ public:
+  explicit WorkStealingDeque(std::size_t capacity = 256) {
+    auto array = std::make_unique<_Array>(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity));
+    _m_array.store(array.get(), std::memory_order_relaxed);
+    _m_arrays.push_back(std::move(array));
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // push, owner only
+  void push(T val) {
+    auto b = _m_bottom.load(std::memory_order_relaxed);
+    auto t = _m_top.load(std::memory_order_acquire);
+    auto* a = _m_array.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::int64_t>(a->mask)) {
+      a = _m_grow(a, t, b);
+    }
+    a->put(b, val);
+    std::atomic_thread_fence(std::memory_order_release);
+    _m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // pop, owner only, lifo
+  // a pointer-like T comes back in a Tagged option (as for steal), a pushed null is Some(null) rather than None
+  details::element_option_t<T> pop() noexcept {
+    auto b = _m_bottom.load(std::memory_order_relaxed) - 1;
+    auto* a = _m_array.load(std::memory_order_relaxed);
+    _m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = _m_top.load(std::memory_order_relaxed);
+    if (t > b) {
+      _m_bottom.store(b + 1, std::memory_order_relaxed);
+      return None;
+    }
+    T val = a->get(b);
+    if (t == b) {
+      // last element, race against thieves for it
+      bool won = _m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      _m_bottom.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return None;
+      }
+    }
+    return details::element_option_t<T>(std::in_place, val);
+  }
+
+  // steal, any thread, fifo; None when empty or when another thread won the race
+  details::element_option_t<T> steal() noexcept {
+    auto t = _m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = _m_bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return None;
+    }
+    T val = _m_array.load(std::memory_order_acquire)->get(t);
+    if (!_m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return None;
+    }
+    return details::element_option_t<T>(std::in_place, val);
+  }
+
+  // approximate, exact only when called by the owner without concurrent thieves
+  std::size_t size() const noexcept {
+    auto b = _m_bottom.load(std::memory_order_relaxed);
+    auto t = _m_top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+ private:
+  struct _Array {
+    explicit _Array(std::size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+    T get(std::int64_t i) const noexcept { return slots[i & mask].load(std::memory_order_relaxed); }
+    void put(std::int64_t i, T val) noexcept { slots[i & mask].store(val, std::memory_order_relaxed); }
+
+    std::int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  // thieves may still read the old array, it is retired only when the deque dies
+  _Array* _m_grow(_Array* a, std::int64_t t, std::int64_t b) {
+    auto bigger = std::make_unique<_Array>(static_cast<std::size_t>(a->mask + 1) * 2);
+    for (auto i = t; i < b; ++i) {
+      bigger->put(i, a->get(i));
+    }
+    auto* raw = bigger.get();
+    _m_arrays.push_back(std::move(bigger));
+    _m_array.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+  alignas(details::cache_line_size) std::atomic<std::int64_t> _m_top{0};
+  alignas(details::cache_line_size) std::atomic<std::int64_t> _m_bottom{0};
+  std::atomic<_Array*> _m_array;
+  std::vector<std::unique_ptr<_Array>> _m_arrays;
+};
+
+}  // namespace navp
@@ -1,9 +1,61 @@
 add_rules("mode.debug", "mode.release")
 
+-- a failed unwrap prints its stack trace with cpptrace, `xmake f --cpptrace=n` builds with the standard library only
+option("cpptrace")
+    set_default(true)
+    set_showmenu(true)
+    set_description("Print the stack trace of a failed unwrap with cpptrace")
+option_end()
+
+-- the package, its include path and its link flags go to every target, like the define
+if has_config("cpptrace") then
+    add_requires("cpptrace")
+    add_packages("cpptrace")
+    add_defines("NAVP_OPTION_CPPTRACE")
+end
+
+-- navp_option, the unwrap failure path compiled once,
+-- a target depending on it sees option.hpp with NAVP_OPTION_LIBRARY and does not include cpptrace
+target("navp_option")
+    set_kind("static")
+    set_languages("c++23")
+    add_includedirs("$(projectdir)", {public = true})
+    add_defines("NAVP_OPTION_LIBRARY", {public = true})
+    add_files("option_library.cpp")
+target_end()
+
 target("test_option")
     set_kind("binary")
     set_languages("c++23")
+    add_deps("navp_option")
     add_includedirs("$(projectdir)")
-    add_packages("cpptrace")
     add_files("test.cpp")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+target_end()
+
+-- the navp.option named module, `import navp.option;` instead of including option.hpp,
+-- only option_module.cpp sees cpptrace when it is enabled; link this library into the importing target
+target("navp_option_module")
+    set_kind("static")
+    set_languages("c++23")
+    set_policy("build.c++.modules", true)
+    add_includedirs("$(projectdir)")
+    add_files("option.cppm", "option_module.cpp")
 target_end()
+
+-- one binary per bench/bench_*.cpp, run with `xmake run bench_xxx`
+for _, file in ipairs(os.files("bench/bench_*.cpp")) do
+    target(path.basename(file))
+        set_kind("binary")
+        set_default(false)
+        set_languages("c++23")
+        add_includedirs("$(projectdir)")
+        add_defines('NAVP_PROJECT_DIR="$(projectdir)"')
+        add_files(file)
+        if is_plat("linux") then
+            add_syslinks("pthread")
+        end
+    target_end()
+end